@@ -0,0 +1,67 @@
+#!/usr/bin/env bats
+
+@test "deposit batch balance" {
+  run cleos transfer myaccount curve.sx "100.0000 A" "batch"
+  echo "Output: $output"
+  [ $status -eq 0 ]
+
+  run cleos transfer myaccount curve.sx "50.0000 A" "batch"
+  [ $status -eq 0 ]
+
+  result=$(cleos get table curve.sx myaccount balances | jq -r '.rows[0].balance.quantity')
+  [ "$result" = "150.0000 A" ]
+
+  run cleos transfer myaccount curve.sx "50.0000 A" "batch,AB"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid memo" ]]
+
+  # tokens which are not a pair reserve are rejected
+  run cleos transfer myaccount curve.sx "1.0000 A" "batch" --contract fake.token
+  [ $status -eq 1 ]
+  [[ "$output" =~ "must be a reserve of an existing pair" ]]
+}
+
+@test "batch swap" {
+  trades_before=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].trades')
+
+  run cleos push action curve.sx batchswap '["myaccount", [{"in": {"quantity": "10.0000 A", "contract": "eosio.token"}, "pair_ids": ["AB"], "min_return": 0}, {"in": {"quantity": "10.0000 A", "contract": "eosio.token"}, "pair_ids": ["AB"], "min_return": 0}, {"in": {"quantity": "10.0000 A", "contract": "eosio.token"}, "pair_ids": ["AB", "BC"], "min_return": 0}]]' -p myaccount
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [ $(echo "$output" | grep -c "curve.sx <= curve.sx::tradelog") -eq 1 ]
+
+  # net outputs & unspent input settled with one transfer per token
+  [ $(echo "$output" | grep -c "curve.sx: batch swap") -eq 3 ]
+
+  # pair row written once per batch, all trades counted
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].trades')
+  [ "$result" = "$((trades_before+3))" ]
+
+  result=$(cleos get table curve.sx myaccount balances | jq -r '.rows | length')
+  [ "$result" = "0" ]
+}
+
+@test "invalid batch swaps" {
+  run cleos push action curve.sx batchswap '["myaccount", []]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no deposited balance" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "batch"
+  [ $status -eq 0 ]
+
+  run cleos push action curve.sx batchswap '["myaccount", [{"in": {"quantity": "20.0000 A", "contract": "eosio.token"}, "pair_ids": ["AB"], "min_return": 0}]]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "insufficient balance" ]]
+
+  run cleos push action curve.sx batchswap '["myaccount", [{"in": {"quantity": "10.0000 A", "contract": "eosio.token"}, "pair_ids": ["AB"], "min_return": 1000000000}]]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid minimum return" ]]
+
+  run cleos push action curve.sx batchswap '["myaccount", [{"in": {"quantity": "10.0000 A", "contract": "eosio.token"}, "pair_ids": ["BC"], "min_return": 0}]]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "contract mismatch" ]]
+
+  # empty orders refund deposited balance
+  run cleos push action curve.sx batchswap '["myaccount", []]' -p myaccount
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: batch swap" ]]
+}
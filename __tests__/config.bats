@@ -19,3 +19,14 @@
   echo $result
   [ $result = "ok" ]
 }
+
+@test "set observation interval" {
+  run cleos push action curve.sx setinterval '[10]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "should be above" ]]
+
+  run cleos push action curve.sx setinterval '[60]' -p curve.sx
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx config | jq -r '.rows[0].observation_interval')
+  [ $result = "60" ]
+}
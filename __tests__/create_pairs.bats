@@ -13,6 +13,15 @@
   run cleos push action curve.sx createpair '["curve.sx", "AB", ["4,A", "eosio.token"], ["4,B", "eosio.token"], 20]' -p curve.sx
   echo "Output: $output"
   [ $status -eq 1 ]
+
+  run cleos push action curve.sx createpair '["curve.sx", "BA", ["4,B", "eosio.token"], ["4,A", "eosio.token"], 20]' -p curve.sx
+  echo "Output: $output"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "reserves pair already exists" ]]
+
+  run cleos push action curve.sx createpair '["curve.sx", "AA", ["4,A", "eosio.token"], ["4,A", "eosio.token"], 20]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "reserves must be different" ]]
 }
 
 @test "create AC" {
@@ -41,3 +50,13 @@
   echo "Output: $output"
   [ $result = CAB ]
 }
+
+@test "pairs by reserve index" {
+  result=$(cleos get table curve.sx curve.sx pairs --index 2 --key-type i128 --lower 0 | jq -r '.rows | length')
+  [ "$result" = "4" ]
+}
+
+@test "pairs by reserve1 index" {
+  result=$(cleos get table curve.sx curve.sx pairs --index 3 --key-type i128 --lower 0 | jq -r '.rows | length')
+  [ "$result" = "4" ]
+}
@@ -0,0 +1,363 @@
+// Native tests for the Curve math kernel (`curve.hpp`)
+//
+// Differential test of the closed-form output reserve solver `Curve::get_y` against the
+// Newton iteration `Curve::get_y_newton` on `formula.bats` vectors and randomized inputs
+//
+// Round-trip of the exact-output solver `Curve::get_amount_in` through `Curve::get_amount_out`
+//
+// Same checks on 3 & 4 coin pools (`Curve::get_amount_out<N>` / `Curve::get_amount_in<N>`)
+//
+// Imbalanced deposits (`Curve::get_deposit_invariant`): proportional deposits are fee-free, single-sided deposits are not
+//
+// ```bash
+// $ bats ./__tests__/kernel.bats
+// ```
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <sx.safemath/safemath.hpp>
+#include "curve.hpp"
+
+static int failures = 0;
+
+#define EXPECT( cond, ... ) do { if ( !(cond) ) { failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while ( 0 )
+
+// expected values from `__tests__/formula.bats`
+static void test_formula()
+{
+    const uint64_t amplifier = 450, reserve1 = 5862496056, reserve2 = 6260058778;
+    const uint8_t fee = 4;
+
+    EXPECT( Curve::get_amount_out( 10000000, reserve1, reserve2, amplifier, fee ) == 9997422, "formula #1" );
+    EXPECT( Curve::get_amount_out( 10000000, reserve2, reserve1, amplifier, fee ) == 9994508, "formula #2" );
+    EXPECT( Curve::get_amount_out( 10000000000, reserve1, reserve2, amplifier, fee ) == 6249264902, "formula #3" );
+    EXPECT( Curve::get_amount_out( 10000000000, reserve2, reserve1, amplifier, fee ) == 5852835188, "formula #4" );
+    EXPECT( Curve::get_amount_out( 10000000, 1000000000000000000, 1000000000000000000, 5, fee ) == 9996000, "formula #5" );
+
+    std::string error;
+    try { Curve::get_amount_out( 10000000, 4000000000000000000, 4000000000000000000, 2, fee ); } catch ( const std::exception& e ) { error = e.what(); }
+    EXPECT( error.find("d1 overflow") != std::string::npos, "formula #6: %s", error.c_str() );
+
+    error = "";
+    try { Curve::get_amount_out( 10000000, 9500000000000000000ULL, 9500000000000000000ULL, amplifier, fee ); } catch ( const std::exception& e ) { error = e.what(); }
+    EXPECT( error.find("invalid reserves") != std::string::npos, "formula #7: %s", error.c_str() );
+
+    // same vectors through both output reserve solvers
+    const uint64_t vectors[][4] = {
+        { 10000000, reserve1, reserve2, amplifier },
+        { 10000000, reserve2, reserve1, amplifier },
+        { 10000000000, reserve1, reserve2, amplifier },
+        { 10000000000, reserve2, reserve1, amplifier },
+        { 10000000, 1000000000000000000, 1000000000000000000, 5 },
+    };
+    for ( const auto& v : vectors ) {
+        const uint64_t D = Curve::get_invariant( v[1], v[2], v[3] );
+        EXPECT( Curve::get_y( v[1] + v[0], D, v[3] ) == Curve::get_y_newton( v[1] + v[0], D, v[3] ), "formula vector amount_in=%lu", v[0] );
+    }
+}
+
+static void test_sqrt( std::mt19937_64& rng, const int cases )
+{
+    for ( int i = 0; i < cases; ++i ) {
+        const int bits = 1 + rng() % 128;
+        const uint128_t n = ((uint128_t(rng()) << 64) | rng()) >> (128 - bits);
+        const uint128_t r = Curve::sqrt( n );
+
+        EXPECT( r <= UINT64_MAX && r * r <= n, "sqrt too large: bits=%d", bits );
+        EXPECT( r == UINT64_MAX || (r + 1) * (r + 1) > n, "sqrt too small: bits=%d", bits );
+    }
+}
+
+static void test_get_y( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0, converged = 0;
+    for ( int i = 0; i < cases; ++i ) {
+        // mix of small, realistic & near-limit reserves
+        const uint64_t range = i % 3 == 0 ? 100000 : i % 3 == 1 ? 1000000000000000ULL : 4000000000000000000ULL;
+        const uint64_t reserve_in = 1 + rng() % range;
+        const uint64_t reserve_out = 1 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % (i % 2 ? 1000000 : 3000);
+        const uint64_t amount_in = 1 + rng() % (reserve_in * 2);
+
+        uint64_t D = 0;
+        try { D = Curve::get_invariant( reserve_in, reserve_out, amplifier ); } catch ( const std::exception& e ) { continue; }
+
+        const int128_t b = (int128_t) (reserve_in + amount_in + (D / (amplifier * 2))) - (int128_t) D;
+        const uint128_t c = uint128_t(D) * D / ((reserve_in + amount_in) * 2) * D / (amplifier * 4);
+        const uint128_t x = Curve::get_y( reserve_in + amount_in, D, amplifier );
+        const uint128_t x_newton = Curve::get_y_newton( reserve_in + amount_in, D, amplifier );
+        tested++;
+
+        // Newton iteration converged (fixed point) => identical rounding
+        if ( (x_newton * x_newton + c) / (2 * x_newton + b) == x_newton ) {
+            converged++;
+            EXPECT( x == x_newton, "get_y mismatch: reserve_in=%lu reserve_out=%lu amplifier=%lu amount_in=%lu", reserve_in, reserve_out, amplifier, amount_in );
+
+        // Newton iteration stopped at `MAX_ITERATIONS` while still decreasing towards the root
+        } else {
+            EXPECT( x <= x_newton, "get_y above unconverged Newton: reserve_in=%lu reserve_out=%lu amplifier=%lu amount_in=%lu", reserve_in, reserve_out, amplifier, amount_in );
+        }
+    }
+    printf("get_y: %d cases, %d converged Newton iterations\n", tested, converged);
+}
+
+static void test_get_amount_in( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0;
+    for ( int i = 0; i < cases; ++i ) {
+        const uint64_t range = i % 3 == 0 ? 100000 : i % 3 == 1 ? 1000000000000000ULL : 4000000000000000000ULL;
+        const uint64_t reserve_in = 1 + rng() % range;
+        const uint64_t reserve_out = 2 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % (i % 2 ? 1000000 : 3000);
+        const uint8_t fee = rng() % 51;
+        const uint64_t amount_out = 1 + rng() % (reserve_out / 2 + 1);
+
+        uint64_t amount_in = 0;
+        try { amount_in = Curve::get_amount_in( amount_out, reserve_in, reserve_out, amplifier, fee ); } catch ( const std::exception& e ) { continue; }
+        uint64_t out = 0;
+        try { out = Curve::get_amount_out( amount_in, reserve_in, reserve_out, amplifier, fee ); } catch ( const std::exception& e ) { continue; }
+        tested++;
+
+        EXPECT( out >= amount_out, "get_amount_in insufficient: reserve_in=%lu reserve_out=%lu amplifier=%lu fee=%u amount_out=%lu => in %lu out %lu", reserve_in, reserve_out, amplifier, fee, amount_out, amount_in, out );
+    }
+    printf("get_amount_in: %d cases\n", tested);
+
+    // example from `curve.hpp`
+    EXPECT( Curve::get_amount_in( 100110, 3432247548, 6169362700, 450, 4 ) == 100000, "get_amount_in example" );
+
+    std::string error;
+    try { Curve::get_amount_in( 100110, 3432247548, 6169362700, 450, Curve::MAX_FEE + 1 ); } catch ( const std::exception& e ) { error = e.what(); }
+    EXPECT( error.find("invalid fee") != std::string::npos, "get_amount_in fee bound: %s", error.c_str() );
+}
+
+template <size_t N>
+static void test_pool( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0;
+    for ( int k = 0; k < cases; ++k ) {
+        const uint64_t range = k % 3 == 0 ? 100000 : k % 3 == 1 ? 1000000000000000ULL : 1000000000000000000ULL;
+        std::array<uint64_t, N> reserves;
+        for ( uint64_t& reserve : reserves ) reserve = 2 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % (k % 2 ? 100000 : 3000);
+        const uint8_t fee = rng() % 51;
+        const size_t i = rng() % N;
+        const size_t j = (i + 1 + rng() % (N - 1)) % N;
+        const uint64_t amount_in = 1 + rng() % reserves[i];
+
+        uint64_t D = 0, amount_out = 0;
+        try {
+            D = Curve::get_invariant<N>( reserves, amplifier );
+            amount_out = Curve::get_amount_out<N>( amount_in, i, j, reserves, amplifier, fee, D );
+        } catch ( const std::exception& e ) { continue; }
+        tested++;
+
+        // reversed reserves => same quote up to integer rounding of the reserves product (symmetric in reserves)
+        std::array<uint64_t, N> reversed;
+        for ( size_t n = 0; n < N; ++n ) reversed[N - 1 - n] = reserves[n];
+        const uint64_t reversed_out = Curve::get_amount_out<N>( amount_in, N - 1 - i, N - 1 - j, reversed, amplifier, fee );
+        const uint64_t diff = reversed_out > amount_out ? reversed_out - amount_out : amount_out - reversed_out;
+        EXPECT( diff <= 10 + amount_out / 1000, "pool<%zu> not symmetric: amplifier=%lu amount_in=%lu out %lu vs %lu", N, amplifier, amount_in, amount_out, reversed_out );
+
+        // closed-form == Newton when Newton converged
+        std::array<uint64_t, N> reserves_new = reserves;
+        reserves_new[i] += amount_in;
+        const uint128_t x = Curve::get_y<N>( reserves_new, j, D, amplifier );
+        const uint128_t x_newton = Curve::get_y_newton<N>( reserves_new, j, D, amplifier );
+        EXPECT( x <= x_newton, "pool<%zu> get_y above Newton: amplifier=%lu amount_in=%lu", N, amplifier, amount_in );
+
+        // exact output round-trip
+        if ( amount_out == 0 ) continue;
+        uint64_t required = 0, out = 0;
+        try {
+            required = Curve::get_amount_in<N>( amount_out, i, j, reserves, amplifier, fee, D );
+            out = Curve::get_amount_out<N>( required, i, j, reserves, amplifier, fee, D );
+        } catch ( const std::exception& e ) { continue; }
+        EXPECT( out >= amount_out, "pool<%zu> get_amount_in insufficient: amplifier=%lu amount_out=%lu => in %lu out %lu", N, amplifier, amount_out, required, out );
+    }
+    printf("pool<%zu>: %d cases\n", N, tested);
+
+    // balanced pool at high amplifier trades close to 1:1
+    std::array<uint64_t, N> balanced;
+    balanced.fill( 1000000000000 );
+    const uint64_t out = Curve::get_amount_out<N>( 1000000, 0, N - 1, balanced, 450, 0 );
+    EXPECT( out <= 1000000 && out >= 999990, "pool<%zu> balanced: %lu", N, out );
+
+    // 2 coin template == 2 coin kernel
+    EXPECT( Curve::get_amount_out<2>( 100000, 0, 1, {3432247548, 6169362700}, 450, 4 ) == Curve::get_amount_out( 100000, 3432247548, 6169362700, 450, 4 ), "pool<2> mismatch" );
+}
+
+static void test_deposit( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0;
+    for ( int k = 0; k < cases; ++k ) {
+        const uint64_t range = k % 2 ? 1000000000000ULL : 100000000000000000ULL;
+        const uint64_t reserve0 = 1000 + rng() % range;
+        const uint64_t reserve1 = 1000 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % 3000;
+        const uint8_t fee = 1 + rng() % 50;
+        const uint64_t amount = 1000 + rng() % (reserve0 / 2 + 1);
+
+        uint64_t D0 = 0, D_single = 0, D_nofee = 0, D_expected = 0;
+        try {
+            D0 = Curve::get_invariant( reserve0, reserve1, amplifier );
+            D_single = Curve::get_deposit_invariant<2>( {amount, 0}, {reserve0, reserve1}, amplifier, fee, D0 );
+            D_nofee = Curve::get_deposit_invariant<2>( {amount, 0}, {reserve0, reserve1}, amplifier, 0, D0 );
+            D_expected = Curve::get_invariant( reserve0 + amount, reserve1, amplifier );
+        } catch ( const std::exception& e ) { continue; }
+        tested++;
+
+        // imbalance fee reduces the invariant gain, never below the initial invariant
+        EXPECT( D_single <= D_nofee && D_single >= D0, "deposit fee: reserve0=%lu reserve1=%lu amplifier=%lu amount=%lu", reserve0, reserve1, amplifier, amount );
+        // warm-started from D0, may differ by 1 from a cold start (see `get_invariant`)
+        EXPECT( D_nofee + 1 >= D_expected && D_nofee <= D_expected + 1, "deposit no fee: reserve0=%lu reserve1=%lu amplifier=%lu amount=%lu", reserve0, reserve1, amplifier, amount );
+    }
+    printf("deposit: %d cases\n", tested);
+
+    // proportional deposit is (nearly) fee-free
+    const uint64_t D0 = Curve::get_invariant( 3000000000000, 1000000000000, 450 );
+    const uint64_t D_balanced = Curve::get_deposit_invariant<2>( {300000000000, 100000000000}, {3000000000000, 1000000000000}, 450, 50, D0 );
+    EXPECT( D_balanced + 10 >= D0 + D0 / 10, "deposit balanced: %lu vs %lu", D_balanced, D0 + D0 / 10 );
+
+    // single-sided deposit into the larger reserve issues less than into the smaller reserve
+    const uint64_t D_large = Curve::get_deposit_invariant<2>( {100000000000, 0}, {3000000000000, 1000000000000}, 450, 4, D0 );
+    const uint64_t D_small = Curve::get_deposit_invariant<2>( {0, 100000000000}, {3000000000000, 1000000000000}, 450, 4, D0 );
+    EXPECT( D_large < D_small, "deposit single-sided: %lu vs %lu", D_large, D_small );
+
+    // 3 coin pool
+    const uint64_t D3 = Curve::get_invariant<3>( {1000000000000, 1000000000000, 1000000000000}, 450 );
+    EXPECT( Curve::get_deposit_invariant<3>( {1000000000, 1000000000, 1000000000}, {1000000000000, 1000000000000, 1000000000000}, 450, 4, D3 ) == D3 + 3000000000, "deposit pool<3> balanced" );
+}
+
+static void test_withdraw_one( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0;
+    for ( int k = 0; k < cases; ++k ) {
+        const uint64_t range = k % 2 ? 1000000000000ULL : 100000000000000000ULL;
+        const uint64_t reserve0 = 1000000 + rng() % range;
+        const uint64_t reserve1 = 1000000 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % 3000;
+        const uint8_t fee = 1 + rng() % 50;
+        const uint64_t supply = reserve0 + reserve1;
+        const uint64_t liquidity = 1 + rng() % (supply / 10);
+
+        uint64_t out = 0, out_nofee = 0, out_expected = 0;
+        try {
+            out = Curve::get_withdraw_one_out<2>( liquidity, supply, 0, {reserve0, reserve1}, amplifier, fee );
+            out_nofee = Curve::get_withdraw_one_out<2>( liquidity, supply, 0, {reserve0, reserve1}, amplifier, 0 );
+
+            // proportional withdrawal, then swap reserve1 share into reserve0 without fee
+            const uint64_t share0 = uint128_t(reserve0) * liquidity / supply;
+            const uint64_t share1 = uint128_t(reserve1) * liquidity / supply;
+            out_expected = share0 + ( share1 ? Curve::get_amount_out( share1, reserve1 - share1, reserve0 - share0, amplifier, 0 ) : 0 );
+        } catch ( const std::exception& e ) { continue; }
+        tested++;
+
+        EXPECT( out <= out_nofee && out < reserve0, "withdraw one fee: reserve0=%lu reserve1=%lu amplifier=%lu liquidity=%lu", reserve0, reserve1, amplifier, liquidity );
+        // same final reserves, differs only by rounding of the proportional shares
+        const uint64_t tolerance = 10 + out_expected / 1000000;
+        EXPECT( out_nofee + tolerance >= out_expected && out_nofee <= out_expected + tolerance, "withdraw one no fee: reserve0=%lu reserve1=%lu amplifier=%lu liquidity=%lu (%lu vs %lu)", reserve0, reserve1, amplifier, liquidity, out_nofee, out_expected );
+    }
+    printf("withdraw one: %d cases\n", tested);
+
+    // balanced pool: withdrawal into one reserve pays (nearly) its share of both reserves
+    const uint64_t out = Curve::get_withdraw_one_out<3>( 3000000000, 3000000000000, 2, {1000000000000, 1000000000000, 1000000000000}, 450, 4 );
+    EXPECT( out < 3000000000 && out > 2990000000, "withdraw one pool<3> balanced: %lu", out );
+}
+
+static void test_depth_ladder( std::mt19937_64& rng, const int cases )
+{
+    static const std::vector<uint64_t> LADDER_BPS = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000 };
+
+    int tested = 0;
+    for ( int k = 0; k < cases / 10; ++k ) {
+        const uint64_t range = k % 2 ? 1000000000000ULL : 100000000000000000ULL;
+        const uint64_t reserve0 = 1000000 + rng() % range;
+        const uint64_t reserve1 = 1000000 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % 3000;
+        const uint8_t fee = rng() % 50;
+
+        std::vector<uint64_t> amounts_in;
+        for ( const uint64_t bps : LADDER_BPS ) amounts_in.push_back( reserve0 / 10000 * bps + 1 );
+
+        std::vector<uint64_t> amounts_out, expected;
+        try {
+            amounts_out = Curve::get_depth_ladder<2>( amounts_in, 0, 1, {reserve0, reserve1}, amplifier, fee );
+            for ( const uint64_t amount_in : amounts_in ) expected.push_back( Curve::get_amount_out( amount_in, reserve0, reserve1, amplifier, fee ) );
+        } catch ( const std::exception& e ) { continue; }
+        tested++;
+
+        for ( size_t p = 0; p < amounts_in.size(); ++p ) {
+            EXPECT( amounts_out[p] + 1 >= expected[p] && amounts_out[p] <= expected[p] + 1, "depth ladder: reserve0=%lu reserve1=%lu amplifier=%lu amount_in=%lu (%lu vs %lu)", reserve0, reserve1, amplifier, amounts_in[p], amounts_out[p], expected[p] );
+            if ( p ) EXPECT( amounts_out[p] >= amounts_out[p - 1], "depth ladder not monotonic: reserve0=%lu reserve1=%lu amplifier=%lu", reserve0, reserve1, amplifier );
+        }
+    }
+    printf("depth ladder: %d cases\n", tested);
+
+    // input amounts must be ascending
+    bool thrown = false;
+    try { Curve::get_depth_ladder<2>( {200000, 100000}, 0, 1, {3432247548, 6169362700}, 450, 4 ); } catch ( const std::exception& e ) { thrown = true; }
+    EXPECT( thrown, "depth ladder: descending input amounts" );
+}
+
+static void test_spot_price( std::mt19937_64& rng, const int cases )
+{
+    int tested = 0;
+    for ( int k = 0; k < cases; ++k ) {
+        const uint64_t range = k % 2 ? 1000000000000ULL : 100000000000000000ULL;
+        const uint64_t reserve0 = 1000000 + rng() % range;
+        const uint64_t reserve1 = 1000000 + rng() % range;
+        const uint64_t amplifier = 1 + rng() % 3000;
+
+        uint64_t price = 0, D = 0;
+        try {
+            D = Curve::get_invariant( reserve0, reserve1, amplifier );
+            price = Curve::get_spot_price( reserve0, reserve1, amplifier, D );
+        } catch ( const std::exception& e ) { continue; }
+        tested++;
+        EXPECT( Curve::get_marginal_price( reserve0, reserve1, amplifier, D ) == price, "marginal price: reserve0=%lu reserve1=%lu amplifier=%lu", reserve0, reserve1, amplifier );
+
+        // implicit derivative in extended precision at the same D
+        const long double x = reserve0, y = reserve1, d = D, Ann = amplifier * 2.0L;
+        const long double prod = d * d * d / (4 * x * y);
+        const long double expected = y * (Ann * x + prod) / (x * (Ann * y + prod)) * Curve::PRICE_SCALE;
+        EXPECT( std::fabs( price - expected ) <= 1 + expected * 1e-12L, "spot price: reserve0=%lu reserve1=%lu amplifier=%lu (%lu vs %.1Lf)", reserve0, reserve1, amplifier, price, expected );
+    }
+    printf("spot price: %d cases\n", tested);
+
+    // balanced reserves trade at par, marginal rate is above any finite trade's rate
+    EXPECT( Curve::get_spot_price( 1000000000000, 1000000000000, 450 ) == Curve::PRICE_SCALE, "spot price balanced" );
+    const uint64_t price = Curve::get_spot_price( 3432247548, 6169362700, 450 );
+    const uint64_t out = Curve::get_amount_out( 1000000, 3432247548, 6169362700, 450, 0 );
+    EXPECT( price >= out * (Curve::PRICE_SCALE / 1000000), "spot price above trade rate: %lu vs %lu", price, out );
+
+    // inverse prices multiply to 1
+    const uint64_t inverse = Curve::get_spot_price( 6169362700, 3432247548, 450 );
+    const long double product = (long double) price * inverse / Curve::PRICE_SCALE / Curve::PRICE_SCALE;
+    EXPECT( std::fabs( product - 1 ) < 1e-8L, "spot price inverse: %lu * %lu", price, inverse );
+}
+
+int main( int argc, char** argv )
+{
+    const int cases = argc > 1 ? atoi( argv[1] ) : 100000;
+    std::mt19937_64 rng( 20210203 );
+
+    test_formula();
+    test_sqrt( rng, cases );
+    test_get_y( rng, cases );
+    test_get_amount_in( rng, cases );
+    test_pool<3>( rng, cases );
+    test_pool<4>( rng, cases );
+    test_deposit( rng, cases );
+    test_withdraw_one( rng, cases );
+    test_depth_ladder( rng, cases );
+    test_spot_price( rng, cases );
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+#!/usr/bin/env bats
+
+@test "single transaction deposit AB" {
+  supply=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].liquidity.quantity')
+  reserve0=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].reserve0.quantity')
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB,0"
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx <= curve.sx::liquiditylog" ]]
+  [[ "$output" =~ "curve.sx: deposit" ]]
+
+  # no pending order is created
+  result=$(cleos get table curve.sx AB orders | jq -r '.rows | length')
+  [ "$result" = "0" ]
+
+  # reserves & supply increase
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].reserve0.quantity')
+  [ "$result" != "$reserve0" ]
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].liquidity.quantity')
+  [ "$result" != "$supply" ]
+}
+
+@test "invalid single transaction deposits" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB,1000000000"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid minimum liquidity" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB,abc"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid memo" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,BC,0"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid extended symbol" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB,0" --contract fake.token
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid extended symbol" ]]
+}
+
+@test "cancel all deposit orders" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB"
+  [ $status -eq 0 ]
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AC"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx orderindex | jq -r '[.rows[] | select(.owner == "myaccount")] | length')
+  [ $result -eq 2 ]
+
+  run cleos push action curve.sx cancelall '["myaccount"]' -p myaccount
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: cancel" ]]
+  result=$(cleos get table curve.sx curve.sx orderindex | jq -r '[.rows[] | select(.owner == "myaccount")] | length')
+  [ $result -eq 0 ]
+  result=$(cleos get table curve.sx AB orders | jq -r '.rows | length')
+  [ $result -eq 0 ]
+
+  run cleos push action curve.sx cancelall '["myaccount"]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no deposits for this user" ]]
+}
+
+@test "expire deposit orders" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "deposit,AB"
+  [ $status -eq 0 ]
+
+  # orders expire after ORDER_EXPIRE_TIME
+  run cleos push action curve.sx expireorders '[10, []]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no expired orders" ]]
+
+  run cleos push action curve.sx cancel '["myaccount", "AB"]' -p myaccount
+  [ $status -eq 0 ]
+}
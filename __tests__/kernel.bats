@@ -0,0 +1,15 @@
+#!/usr/bin/env bats
+
+# native (host) build of the Curve math kernel, does not require nodeos
+setup() {
+  mkdir -p build
+  [ -f build/curve.test ] && [ build/curve.test -nt curve.hpp ] && [ build/curve.test -nt __tests__/curve.test.cpp ] && return
+  g++ -std=c++17 -O2 -Wall -Wextra -Werror -Wno-unused-function -I bench/include -I include -I . __tests__/curve.test.cpp -o build/curve.test
+}
+
+@test "kernel formula vectors & differential get_y" {
+  run ./build/curve.test 200000
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "OK" ]]
+}
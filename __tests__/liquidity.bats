@@ -19,6 +19,8 @@ load bats.global
   [ "$result" = "$((AB_LIQ)).0000 B" ]
   result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].liquidity.quantity')
   [ "$result" = "$((2*AB_LIQ)).0000 AB" ]
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].invariant')
+  [ "$result" = "$((2*AB_LIQ))000000000" ]
   result=$(cleos get currency balance lptoken.sx liquidity.sx)
   [ "$result" = "$((2*AB_LIQ)).0000 AB" ]
 }
@@ -0,0 +1,118 @@
+#!/usr/bin/env bats
+
+@test "create ABC pool" {
+  run cleos push action curve.sx createpool '["curve.sx", "ABC", [["4,A", "eosio.token"], ["4,B", "eosio.token"], ["9,C", "eosio.token"]], 450]' -p curve.sx
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].id')
+  [ $result = ABC ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].liquidity.quantity')
+  [ "$result" = "0.000000000 ABC" ]
+}
+
+@test "invalid pools" {
+  run cleos push action curve.sx createpool '["curve.sx", "ABC", [["4,A", "eosio.token"], ["4,B", "eosio.token"], ["9,C", "eosio.token"]], 450]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "already exists" ]]
+
+  run cleos push action curve.sx createpool '["curve.sx", "AB", [["4,A", "eosio.token"], ["4,B", "eosio.token"], ["9,C", "eosio.token"]], 450]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "already exists in \`pairs\`" ]]
+
+  run cleos push action curve.sx createpool '["curve.sx", "ABX", [["4,A", "eosio.token"], ["4,B", "eosio.token"]], 450]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "pool must have between" ]]
+
+  run cleos push action curve.sx createpool '["curve.sx", "ABX", [["4,A", "eosio.token"], ["4,B", "eosio.token"], ["4,A", "eosio.token"]], 450]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "duplicate reserve" ]]
+}
+
+@test "deposit ABC" {
+  run cleos transfer myaccount curve.sx "1000.0000 A" "deposit,ABC"
+  [ $status -eq 0 ]
+  run cleos transfer myaccount curve.sx "1000.0000 B" "deposit,ABC"
+  [ $status -eq 0 ]
+  run cleos transfer myaccount curve.sx "1100.000000000 C" "deposit,ABC"
+  [ $status -eq 0 ]
+
+  result=$(cleos get table curve.sx ABC poolorders | jq -r '.rows[0].quantities[2].quantity')
+  [ "$result" = "1100.000000000 C" ]
+
+  run cleos push action curve.sx deposit '["myaccount", "ABC"]' -p myaccount
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "100.000000000 C" ]]
+
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].reserves[0].quantity')
+  [ "$result" = "1000.0000 A" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].reserves[2].quantity')
+  [ "$result" = "1000.000000000 C" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].liquidity.quantity')
+  [ "$result" = "3000.000000000 ABC" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].invariant')
+  [ "$result" = "3000000000000" ]
+  result=$(cleos get currency balance lptoken.sx myaccount ABC)
+  [ "$result" = "3000.000000000 ABC" ]
+}
+
+@test "swap via ABC pool" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,0,ABC,C"
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: swap token" ]]
+
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].reserves[0].quantity')
+  [ "$result" = "1010.0000 A" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].trades')
+  [ "$result" = "1" ]
+
+  run cleos transfer myaccount curve.sx "10.0000 B" "swappool,0,ABC,A"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].volumes[1]')
+  [ "$result" = "10.0000 B" ]
+}
+
+@test "invalid pool swaps" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,100000000000,ABC,C"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid minimum return" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,0,ABC,A"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "input and output reserves must be different" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,0,ABC,X"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no such reserve in pool" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,0,XYZ,C"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "\`pool_id\` does not exist" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swappool,0,ABC,C" --contract fake.token
+  [ $status -eq 1 ]
+  [[ "$output" =~ "incoming currency/reserves contract mismatch" ]]
+}
+
+@test "withdraw ABC" {
+  abc_balance=$(cleos get currency balance lptoken.sx myaccount ABC)
+
+  run cleos transfer myaccount curve.sx "$abc_balance" "" --contract lptoken.sx
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].liquidity.quantity')
+  [ "$result" = "0.000000000 ABC" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].reserves[0].quantity')
+  [ "$result" = "0.0000 A" ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows[0].reserves[2].quantity')
+  [ "$result" = "0.000000000 C" ]
+}
+
+@test "remove ABC pool" {
+  run cleos push action curve.sx removepool '["ABC"]' -p curve.sx
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx pools | jq -r '.rows | length')
+  [ "$result" = "0" ]
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env bats
+
+@test "quote matches executed swap" {
+  run cleos push action curve.sx quote '[[{"in": "10.0000 A", "pair_ids": ["AB"]}, {"in": "10.0000 A", "pair_ids": ["AB", "BC"]}]]' -p myaccount --read --json
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  quoted=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data[0].out')
+  [[ "$quoted" =~ " B" ]]
+  result=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data[1].out')
+  [[ "$result" =~ " C" ]]
+  result=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data[1].trades | length')
+  [ "$result" = "2" ]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB"
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "$quoted" ]]
+}
+
+@test "invalid quotes" {
+  run cleos push action curve.sx quote '[[{"in": "10.0000 A", "pair_ids": []}]]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "\`pair_ids\` cannot be empty" ]]
+
+  run cleos push action curve.sx quote '[[{"in": "10.0000 A", "pair_ids": ["XY"]}]]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "\`pair_id\` does not exist" ]]
+}
+
+@test "depth ladder matches quotes" {
+  run cleos push action curve.sx depth '["AB", ["1.0000 A", "10.0000 A", "100.0000 A"]]' -p myaccount --read --json
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  ladder=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data[1]')
+  [[ "$ladder" =~ " B" ]]
+
+  run cleos push action curve.sx quote '[[{"in": "10.0000 A", "pair_ids": ["AB"]}]]' -p myaccount --read --json
+  [ $status -eq 0 ]
+  result=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data[0].out')
+  [ "$result" = "$ladder" ]
+}
+
+@test "invalid depth ladders" {
+  run cleos push action curve.sx depth '["AB", ["10.0000 A", "1.0000 A"]]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "input amounts must be ascending" ]]
+
+  run cleos push action curve.sx depth '["AB", ["1.0000 A", "10.0000 B"]]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "input symbols must match" ]]
+}
+
+@test "spot price" {
+  run cleos push action curve.sx spotprice '["AB", "A"]' -p myaccount --read --json
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  price=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data')
+  [ "$price" -gt 0 ]
+
+  run cleos push action curve.sx spotprice '["AB", "B"]' -p myaccount --read --json
+  [ $status -eq 0 ]
+  inverse=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data')
+  # price * inverse ~= 1e18
+  product=$(echo "$price * $inverse / 1000000000" | bc)
+  [ "$product" -gt 999999000 ]
+  [ "$product" -lt 1000001000 ]
+
+  run cleos push action curve.sx spotprice '["AB", "C"]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no such reserve in pairs" ]]
+}
+
+@test "deposit & withdraw previews" {
+  run cleos push action curve.sx depositout '["AB", "10.0000 A", "10.0000 B"]' -p myaccount --read --json
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  issued=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data.issued')
+  [[ "$issued" =~ "AB" ]]
+
+  run cleos push action curve.sx withdrawout '["10.0000 AB"]' -p myaccount --read --json
+  [ $status -eq 0 ]
+  out0=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data.out0')
+  out1=$(echo "$output" | jq -r '.processed.action_traces[0].return_value_data.out1')
+  [[ "$out0" =~ " A" ]]
+  [[ "$out1" =~ " B" ]]
+
+  run cleos push action curve.sx depositout '["AB", "10.0000 A", "0.0000 B"]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "one of the deposit is empty" ]]
+
+  run cleos push action curve.sx withdrawout '["10.0000 AD"]' -p myaccount --read
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid pair id" ]]
+}
@@ -60,7 +60,7 @@
 
 @test "stop ramp" {
 
-  amp=$(cleos get table curve.sx curve.sx ramp | jq -r '.rows[0].target_amplifier')
+  amp=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].ramp.target_amplifier')
   if [[ "$amp" != "200" ]]; then
       skip "no ramp set - production configuration?"
   fi
@@ -69,10 +69,22 @@
   [ $status -eq 1 ]
   [[ "$output" =~ "does not exist in" ]]
 
+  amp_before=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].amplifier')
   run cleos push action curve.sx stopramp '["AB"]' -p curve.sx
   [ $status -eq 0 ]
 
-  amp=$(cleos get table curve.sx curve.sx ramp | jq -r '.rows[0].target_amplifier')
-  [ -n "$amp" ]
+  # ramp is cleared, last stored amplifier is kept
+  amp=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].ramp.target_amplifier')
+  [ "$amp" = "0" ]
+  amp=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].amplifier')
+  [ "$amp" = "$amp_before" ]
+
+  run cleos push action curve.sx stopramp '["AB"]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "does not exist in" ]]
+
+  # AC ramp still in progress
+  amp=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[1].ramp.target_amplifier')
+  [ "$amp" = "100" ]
 
 }
@@ -119,6 +119,108 @@ load bats.global
   [[ "$output" =~ "{\"pair_id\":\"AB\"" ]]
 }
 
+@test "3 hop swap" {
+  trades_before=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[1].trades')
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB-BC-AC"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "{\"pair_id\":\"BC\"" ]]
+  [ $(echo "$output" | grep -c "curve.sx <= curve.sx::tradelog") -eq 1 ]
+
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[1].trades')
+  [ "$result" = "$((trades_before+1))" ]
+}
+
+@test "swap exact output" {
+  b_before=$(cleos get currency balance eosio.token myaccount B | awk '{print $1}')
+  a_before=$(cleos get currency balance eosio.token myaccount A | awk '{print $1}')
+
+  run cleos transfer myaccount curve.sx "110.0000 A" "swapout,1100000,1000000,AB"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: refund" ]]
+
+  b_after=$(cleos get currency balance eosio.token myaccount B | awk '{print $1}')
+  a_after=$(cleos get currency balance eosio.token myaccount A | awk '{print $1}')
+  awk -v before=$b_before -v after=$b_after 'BEGIN { exit !(after - before >= 100) }'
+  awk -v before=$a_before -v after=$a_after 'BEGIN { exit !(before - after < 110) }'
+
+  run cleos transfer myaccount curve.sx "110.0000 A" "swapout,1100000,1000000000000,AB-BC"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: refund" ]]
+}
+
+@test "invalid exact output swaps" {
+  run cleos transfer myaccount curve.sx "110.0000 A" "swapout,900000,1000000,AB"
+  echo "$output"
+  [[ "$output" =~ "exceeds maximum input" ]]
+  [ $status -eq 1 ]
+
+  run cleos transfer myaccount curve.sx "90.0000 A" "swapout,1100000,1000000,AB"
+  echo "$output"
+  [[ "$output" =~ "insufficient input amount" ]]
+  [ $status -eq 1 ]
+
+  run cleos transfer myaccount curve.sx "110.0000 A" "swapout,1100000,1000000"
+  echo "$output"
+  [[ "$output" =~ "invalid memo" ]]
+  [ $status -eq 1 ]
+
+  run cleos transfer myaccount curve.sx "110.0000 A" "swapout,1100000,1000000,BC"
+  echo "$output"
+  [[ "$output" =~ "contract mismatch" ]]
+  [ $status -eq 1 ]
+}
+
+@test "auto route swap" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,auto,C"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: swap token" ]]
+  [[ "$output" =~ " C\"" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,auto,X"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no route found" ]]
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,auto"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid memo" ]]
+}
+
+@test "split route swap" {
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AC:60|AB-BC:40"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "{\"pair_id\":\"AC\"" ]]
+  [[ "$output" =~ "{\"pair_id\":\"BC\"" ]]
+  [ $(echo "$output" | grep -c "curve.sx <= curve.sx::tradelog") -eq 1 ]
+  [ $(echo "$output" | grep -c "curve.sx: swap token") -eq 1 ]
+
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AC|AB-BC"
+  echo "$output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx: swap token" ]]
+
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AC:60|AB-BC:30"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "weights must sum to 100" ]]
+
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AC:60|AB-BC"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid memo" ]]
+
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AB|AB-BC"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "legs must not share pairs" ]]
+
+  run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AC|AB"
+  [ $status -eq 1 ]
+  [[ "$output" =~ "legs output mismatch" ]]
+}
+
 @test "swap with protocol fee" {
   run cleos push action curve.sx setfee '[4, 1, "fee.sx"]' -p curve.sx
   [ $status -eq 0 ]
@@ -128,24 +230,52 @@ load bats.global
 
   run cleos transfer myaccount curve.sx "100.0000 A" "swap,0,AB"
   [ $status -eq 0 ]
-  [[ "$output" =~ "0.0100 A" ]]
   [[ "$output" =~ "99.8150 B" ]]
 
   run cleos transfer myaccount curve.sx "100.0000 B" "swap,0,AB"
-  [[ "$output" =~ "0.0100 B" ]]
   [[ "$output" =~ "100.0851 A" ]]
   [ $status -eq 0 ]
 
   run cleos transfer myaccount curve.sx "100.0000 C" "swap,0,CAB"
-  [[ "$output" =~ "0.010000000 C" ]]
   [[ "$output" =~ "99.9357 AB" ]]
   [ $status -eq 0 ]
 
   run cleos transfer myaccount curve.sx "100.0000 AB" "swap,0,CAB" --contract lptoken.sx
-  [[ "$output" =~ "0.0100 AB" ]]
   [[ "$output" =~ "99.964233225 C" ]]
   [ $status -eq 0 ]
 
+  # protocol fees are accrued, not transferred per swap
+  fee_balance=$(cleos get currency balance eosio.token fee.sx)
+  [ "$fee_balance" = "" ]
+  result=$(cleos get table curve.sx curve.sx fees | jq -r '.rows[0].balance.quantity')
+  [ "$result" = "0.0100 A" ]
+  result=$(cleos get table curve.sx curve.sx fees | jq -r '.rows | length')
+  [ "$result" = "4" ]
+
+  # single token claim
+  run cleos push action curve.sx claimfees '[10, {"sym": "4,B", "contract": "eosio.token"}]' -p myaccount
+  echo "$output"
+  [ $status -eq 0 ]
+
+  fee_balance=$(cleos get currency balance eosio.token fee.sx B)
+  [ "$fee_balance" = "0.0100 B" ]
+
+  fee_balance=$(cleos get currency balance eosio.token fee.sx A)
+  [ "$fee_balance" = "" ]
+
+  # bounded batch, remaining tokens claimed by next call
+  run cleos push action curve.sx claimfees '[1, null]' -p myaccount
+  [ $status -eq 0 ]
+
+  fee_balance=$(cleos get currency balance eosio.token fee.sx A)
+  [ "$fee_balance" = "0.0100 A" ]
+
+  fee_balance=$(cleos get currency balance eosio.token fee.sx C)
+  [ "$fee_balance" = "" ]
+
+  run cleos push action curve.sx claimfees '[10, null]' -p myaccount
+  [ $status -eq 0 ]
+
   fee_balance=$(cleos get currency balance eosio.token fee.sx A)
   [ "$fee_balance" = "0.0100 A" ]
 
@@ -158,11 +288,112 @@ load bats.global
   fee_balance=$(cleos get currency balance lptoken.sx fee.sx)
   [ "$fee_balance" = "0.0100 AB" ]
 
+  # paid out rows are erased
+  result=$(cleos get table curve.sx curve.sx fees | jq -r '.rows | length')
+  [ "$result" = "0" ]
+
+  run cleos push action curve.sx claimfees '[10, null]' -p myaccount
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no protocol fees to claim" ]]
+
   run cleos push action curve.sx setfee '[4, 0, "fee.sx"]' -p curve.sx
   [ $status -eq 0 ]
 }
 
 
+@test "price accumulators" {
+  start=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].oracle')
+  sleep 2
+
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB"
+  [ $status -eq 0 ]
+
+  end=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].oracle')
+  [ $(echo "$start" | jq -r '.timestamp') != $(echo "$end" | jq -r '.timestamp') ]
+  [ $(echo "$start" | jq -r '.price0_cumulative') != $(echo "$end" | jq -r '.price0_cumulative') ]
+  [ $(echo "$start" | jq -r '.price1_cumulative') != $(echo "$end" | jq -r '.price1_cumulative') ]
+}
+
+@test "fixed-point prices" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB"
+  [ $status -eq 0 ]
+  price=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].prices.price1_last')
+  [[ $price =~ ^[0-9]+$ ]]
+  [ "$price" != "0" ]
+
+  run cleos push action curve.sx migrate '[10]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no pairs to migrate" ]]
+}
+
+@test "migrate legacy pairs" {
+  # pair created by the pre-upgrade contract, extensions are populated by `migrate`
+  run ./scripts/legacy.sh '["curve.sx", "AAB", ["4,A", "eosio.token"], ["4,AB", "lptoken.sx"], 20]'
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx curve.sx pairs -l 100 | jq -c '.rows[] | select(.id == "AAB") | [.invariant, .ramp, .scales, .oracle, .prices]')
+  [ "$result" = "[null,null,null,null,null]" ]
+  observations=$(cleos get table curve.sx AB observations | jq -r '.rows | length')
+
+  run cleos push action curve.sx migrate '[10]' -p curve.sx
+  echo "$output"
+  [ $status -eq 0 ]
+
+  result=$(cleos get table curve.sx curve.sx pairs -l 100 | jq -c '.rows[] | select(.id == "AAB") | [.ramp.target_amplifier, .scales.scale_lp, .prices.virtual_price]')
+  [ "$result" = "[0,100000,0]" ]
+
+  # legacy prices are left untouched & observations are kept
+  result=$(cleos get table curve.sx curve.sx pairs -l 100 | jq -r '.rows[] | select(.id == "AAB") | .virtual_price')
+  [ $(echo "$result" | awk '{ print ($1 == 0) }') = "1" ]
+  result=$(cleos get table curve.sx AB observations | jq -r '.rows | length')
+  [ "$result" = "$observations" ]
+
+  run cleos push action curve.sx migrate '[10]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no pairs to migrate" ]]
+
+  run cleos push action curve.sx removepair '["AAB"]' -p curve.sx
+  [ $status -eq 0 ]
+}
+
+@test "migrate re-indexes legacy pairs" {
+  # pair created before the `pairs` secondary indices existed
+  run ./scripts/legacy.sh '["curve.sx", "AFB", ["4,A", "fake.token"], ["4,B", "eosio.token"], 20]'
+  [ $status -eq 0 ]
+
+  run cleos push action curve.sx migrate '[10]' -p curve.sx
+  echo "$output"
+  [ $status -eq 0 ]
+
+  # duplicate check (`bytokens`)
+  run cleos push action curve.sx createpair '["curve.sx", "BFA", ["4,B", "eosio.token"], ["4,A", "fake.token"], 20]' -p curve.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "reserves pair already exists" ]]
+
+  # reserve lookup (`byreserve0`)
+  run cleos transfer myaccount curve.sx "1.0000 A" "batch" --contract fake.token
+  echo "$output"
+  [ $status -eq 0 ]
+  run cleos push action curve.sx batchswap '["myaccount", []]' -p myaccount
+  [ $status -eq 0 ]
+
+  run cleos push action curve.sx removepair '["AFB"]' -p curve.sx
+  [ $status -eq 0 ]
+}
+
+@test "observations ring buffer" {
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB"
+  [ $status -eq 0 ]
+  count=$(cleos get table curve.sx AB observations | jq -r '.rows | length')
+  [ $count -ge 1 ]
+
+  # at most one observation per interval
+  run cleos transfer myaccount curve.sx "10.0000 A" "swap,0,AB"
+  [ $status -eq 0 ]
+  result=$(cleos get table curve.sx AB observations | jq -r '.rows | length')
+  [ $result -le $((count + 1)) ]
+  [ $result -le 48 ]
+}
+
 @test "50 random swaps" {
   symbols="ABC"
   pairs=("AB" "BC" "AC")
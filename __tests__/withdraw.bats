@@ -9,6 +9,34 @@
   [[ "$output" =~ "invalid liquidity contract" ]]
 }
 
+@test "withdraw into single reserve" {
+  reserve1=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].reserve1.quantity')
+
+  run cleos transfer myaccount curve.sx "1.0000 AB" "withdrawone,A,0" --contract lptoken.sx
+  echo "Output: $output"
+  [ $status -eq 0 ]
+  [[ "$output" =~ "curve.sx <= curve.sx::liquiditylog" ]]
+  [[ "$output" =~ "curve.sx: withdraw" ]]
+
+  # other reserve is untouched
+  result=$(cleos get table curve.sx curve.sx pairs | jq -r '.rows[0].reserve1.quantity')
+  [ "$result" = "$reserve1" ]
+}
+
+@test "invalid withdraw into single reserve" {
+  run cleos transfer myaccount curve.sx "1.0000 AB" "withdrawone,A,100000000" --contract lptoken.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid minimum return" ]]
+
+  run cleos transfer myaccount curve.sx "1.0000 AB" "withdrawone,C,0" --contract lptoken.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "no such reserve in pairs" ]]
+
+  run cleos transfer myaccount curve.sx "1.0000 AB" "withdrawone,A" --contract lptoken.sx
+  [ $status -eq 1 ]
+  [[ "$output" =~ "invalid memo" ]]
+}
+
 @test "withdraw all" {
   cab_balance=$(cleos get currency balance lptoken.sx liquidity.sx CAB)
 
@@ -0,0 +1,193 @@
+// Native microbenchmark for `Curve::get_amount_out`
+//
+// Sweeps amount, reserve-imbalance & amplifier grids and reports per quote:
+// - ns/quote
+// - Newton iterations of the D loop & the x loop
+// - 128-bit divisions
+//
+// Each grid point is measured cold (D solved from the sum of reserves) and
+// warm (D hint cached from the previous trade, see `Curve::get_invariant`).
+//
+// Balanced 2, 3 & 4 coin pools are compared with `Curve::get_amount_out<N>`.
+//
+// Depth ladders (`Curve::get_depth_ladder`) are compared with one quote per point.
+//
+// ```bash
+// $ ./scripts/bench.sh [repetitions]
+// ```
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct curve_profile {
+    uint64_t d_iterations;
+    uint64_t x_iterations;
+    uint64_t divisions;
+};
+static curve_profile profile;
+
+#define CURVE_PROFILE( counter, value ) profile.counter += value
+
+#include <eosio/eosio.hpp>
+#include <sx.safemath/safemath.hpp>
+#include <sx.rex/rex.hpp>
+#include "curve.hpp"
+
+// reserves are normalized to `MAX_PRECISION` (9 decimals) like in `sx::curve::get_amount_out`
+static const uint64_t TOTAL_RESERVES = 200'000'000000000;     // 200K tokens
+static const uint8_t TRADE_FEE = 4;
+
+static const std::vector<uint64_t> AMPLIFIERS = { 1, 20, 100, 450, 2000, 10000 };
+static const std::vector<uint64_t> IMBALANCES = { 50, 70, 90, 99 };                  // reserve_in share in %
+static const std::vector<uint64_t> AMOUNTS_BPS = { 1, 10, 100, 1000, 5000 };         // amount_in in bps of reserve_in
+
+// average ns per call of `fn` over `repetitions` calls
+template <typename F>
+static double measure( const int repetitions, F fn )
+{
+    const auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < repetitions; ++i ) fn( i );
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>( end - start ).count() / repetitions;
+}
+
+// average over amplifiers of a balanced N coin pool quote
+template <size_t N>
+static void bench_pool( const int repetitions, volatile uint64_t& sink )
+{
+    std::array<uint64_t, N> reserves;
+    reserves.fill( TOTAL_RESERVES / N );
+    const uint64_t amount_in = reserves[0] / 10000 * 10;
+
+    double ns = 0, warm_ns = 0;
+    curve_profile totals = {};
+    for ( const uint64_t amplifier : AMPLIFIERS ) {
+        const uint64_t D = Curve::get_invariant<N>( reserves, amplifier );
+        profile = {};
+        Curve::get_amount_out<N>( amount_in, 0, N - 1, reserves, amplifier, TRADE_FEE );
+        totals.d_iterations += profile.d_iterations;
+        totals.divisions += profile.divisions;
+
+        ns += measure( repetitions, [&]( const int i ) {
+            sink += Curve::get_amount_out<N>( amount_in + (i & 1), 0, N - 1, reserves, amplifier, TRADE_FEE );
+        });
+        warm_ns += measure( repetitions, [&]( const int i ) {
+            sink += Curve::get_amount_out<N>( amount_in + (i & 1), 0, N - 1, reserves, amplifier, TRADE_FEE, D );
+        });
+    }
+    const double points = AMPLIFIERS.size();
+    printf("%6zu %12.1f %12.1f %9.2f %9.2f\n", N, ns / points, warm_ns / points, totals.d_iterations / points, totals.divisions / points);
+}
+
+int main( int argc, char** argv )
+{
+    const int repetitions = argc > 1 ? atoi( argv[1] ) : 2000;
+    volatile uint64_t sink = 0;
+
+    printf("%10s %8s %10s %14s %12s %9s %9s %9s %12s %9s %9s\n", "amplifier", "in/out%", "amount_bps", "amount_out", "ns/quote", "D iters", "x iters", "div128", "ns/warm", "D warm", "div warm");
+
+    double total_ns = 0, total_warm_ns = 0;
+    uint64_t total_quotes = 0;
+    curve_profile totals = {}, warm_totals = {};
+
+    for ( const uint64_t amplifier : AMPLIFIERS ) {
+        for ( const uint64_t imbalance : IMBALANCES ) {
+            for ( const uint64_t bps : AMOUNTS_BPS ) {
+                const uint64_t reserve_in = TOTAL_RESERVES / 100 * imbalance;
+                const uint64_t reserve_out = TOTAL_RESERVES - reserve_in;
+                const uint64_t amount_in = reserve_in / 10000 * bps;
+
+                // single instrumented call (skip grid points outside of the kernel's valid range)
+                profile = {};
+                uint64_t amount_out = 0;
+                try {
+                    amount_out = Curve::get_amount_out( amount_in, reserve_in, reserve_out, amplifier, TRADE_FEE );
+                } catch ( const std::exception& e ) {
+                    printf("%10lu %5lu/%-2lu %10lu %s\n", amplifier, imbalance, 100 - imbalance, bps, e.what());
+                    continue;
+                }
+                const curve_profile calls = profile;
+
+                // warm-started call (invariant cached in `pairs` row)
+                const uint64_t D = Curve::get_invariant( reserve_in, reserve_out, amplifier );
+                profile = {};
+                Curve::get_amount_out( amount_in, reserve_in, reserve_out, amplifier, TRADE_FEE, D );
+                const curve_profile warm_calls = profile;
+
+                // timed calls
+                const double ns = measure( repetitions, [&]( const int i ) {
+                    sink += Curve::get_amount_out( amount_in + (i & 1), reserve_in, reserve_out, amplifier, TRADE_FEE );
+                });
+                const double warm_ns = measure( repetitions, [&]( const int i ) {
+                    sink += Curve::get_amount_out( amount_in + (i & 1), reserve_in, reserve_out, amplifier, TRADE_FEE, D );
+                });
+
+                printf("%10lu %5lu/%-2lu %10lu %14lu %12.1f %9lu %9lu %9lu %12.1f %9lu %9lu\n", amplifier, imbalance, 100 - imbalance, bps, amount_out, ns, calls.d_iterations, calls.x_iterations, calls.divisions, warm_ns, warm_calls.d_iterations, warm_calls.divisions);
+
+                total_ns += ns;
+                total_warm_ns += warm_ns;
+                total_quotes += 1;
+                totals.d_iterations += calls.d_iterations;
+                totals.x_iterations += calls.x_iterations;
+                totals.divisions += calls.divisions;
+                warm_totals.d_iterations += warm_calls.d_iterations;
+                warm_totals.divisions += warm_calls.divisions;
+            }
+        }
+    }
+    printf("\naverage: %.1f ns/quote, %.2f D iters, %.2f x iters, %.2f div128 per call (%lu grid points)\n",
+        total_ns / total_quotes, (double) totals.d_iterations / total_quotes, (double) totals.x_iterations / total_quotes, (double) totals.divisions / total_quotes, total_quotes);
+    printf("warm D:  %.1f ns/quote, %.2f D iters, %.2f div128 per call\n",
+        total_warm_ns / total_quotes, (double) warm_totals.d_iterations / total_quotes, (double) warm_totals.divisions / total_quotes);
+
+    // output reserve solvers: closed-form `get_y` (default) vs. Newton iteration `get_y_newton`
+    double y_ns = 0, y_newton_ns = 0;
+    uint64_t y_points = 0;
+    for ( const uint64_t amplifier : AMPLIFIERS ) {
+        for ( const uint64_t imbalance : IMBALANCES ) {
+            for ( const uint64_t bps : AMOUNTS_BPS ) {
+                const uint64_t reserve_in = TOTAL_RESERVES / 100 * imbalance;
+                const uint64_t reserve_out = TOTAL_RESERVES - reserve_in;
+                const uint64_t amount_in = reserve_in / 10000 * bps;
+                uint64_t D = 0;
+                try { D = Curve::get_invariant( reserve_in, reserve_out, amplifier ); } catch ( const std::exception& e ) { continue; }
+
+                y_ns += measure( repetitions, [&]( const int i ) {
+                    sink += Curve::get_y( reserve_in + amount_in + (i & 1), D, amplifier );
+                });
+                y_newton_ns += measure( repetitions, [&]( const int i ) {
+                    sink += Curve::get_y_newton( reserve_in + amount_in + (i & 1), D, amplifier );
+                });
+                y_points += 1;
+            }
+        }
+    }
+    printf("y solver: %.1f ns closed-form (get_y), %.1f ns Newton (get_y_newton)\n", y_ns / y_points, y_newton_ns / y_points);
+
+    // N coin pools (balanced reserves, 10 bps trade)
+    printf("\n%6s %12s %12s %9s %9s\n", "coins", "ns/quote", "ns/warm", "D iters", "div128");
+    bench_pool<2>( repetitions, sink );
+    bench_pool<3>( repetitions, sink );
+    bench_pool<4>( repetitions, sink );
+
+    // depth ladder: D solved once & seeded y solver vs. one quote per point (balanced pair)
+    static const std::vector<uint64_t> LADDER_BPS = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000 };
+    std::vector<uint64_t> amounts_in;
+    for ( const uint64_t bps : LADDER_BPS ) amounts_in.push_back( TOTAL_RESERVES / 2 / 10000 * bps );
+    double ladder_ns = 0, quotes_ns = 0;
+    for ( const uint64_t amplifier : AMPLIFIERS ) {
+        ladder_ns += measure( repetitions, [&]( const int i ) {
+            sink += Curve::get_depth_ladder<2>( amounts_in, 0, 1, {TOTAL_RESERVES / 2 + (i & 1), TOTAL_RESERVES / 2}, amplifier, TRADE_FEE ).back();
+        });
+        quotes_ns += measure( repetitions, [&]( const int i ) {
+            for ( const uint64_t amount_in : amounts_in ) sink += Curve::get_amount_out( amount_in, TOTAL_RESERVES / 2 + (i & 1), TOTAL_RESERVES / 2, amplifier, TRADE_FEE );
+        });
+    }
+    const double points = AMPLIFIERS.size();
+    printf("\ndepth ladder (%zu points): %.1f ns get_depth_ladder, %.1f ns get_amount_out per point\n", amounts_in.size(), ladder_ns / points, quotes_ns / points);
+
+    return sink == 42 ? 1 : 0;
+}
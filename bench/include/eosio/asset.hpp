@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * Minimal host shim of `eosio/asset.hpp` used to build `sx.utils` parsers natively (x86-64 Linux)
+ *
+ * Provides only what `sx.utils` requires:
+ *
+ * - `eosio::name` / `eosio::symbol_code` / `eosio::symbol` (same encoding as eosio.cdt)
+ * - `eosio::asset` / `eosio::extended_symbol` / `eosio::extended_asset` (value holders)
+ */
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "eosio.hpp"
+
+namespace eosio {
+    struct name {
+        uint64_t value = 0;
+
+        constexpr name() = default;
+        constexpr explicit name( const uint64_t v ) : value( v ) {}
+        explicit name( const std::string_view str )
+        {
+            check( str.size() <= 13, "string is too long to be a valid name" );
+            const uint32_t n = std::min( (uint32_t) str.size(), (uint32_t) 12 );
+            for ( uint32_t i = 0; i < n; ++i ) {
+                value <<= 5;
+                value |= char_to_value( str[i] );
+            }
+            value <<= ( 4 + 5 * ( 12 - n ) );
+            if ( str.size() == 13 ) value |= char_to_value( str[12] );
+        }
+
+        static uint8_t char_to_value( const char c )
+        {
+            if ( c == '.' ) return 0;
+            else if ( c >= '1' && c <= '5' ) return ( c - '1' ) + 1;
+            else if ( c >= 'a' && c <= 'z' ) return ( c - 'a' ) + 6;
+            check( false, "character is not in allowed character set for names" );
+            return 0;
+        }
+
+        friend constexpr bool operator==( const name a, const name b ) { return a.value == b.value; }
+        friend constexpr bool operator!=( const name a, const name b ) { return a.value != b.value; }
+    };
+
+    struct symbol_code {
+        uint64_t value = 0;
+
+        constexpr symbol_code() = default;
+        constexpr explicit symbol_code( const uint64_t raw ) : value( raw ) {}
+        explicit symbol_code( const std::string_view str )
+        {
+            check( str.size() <= 7, "string is too long to be a valid symbol_code" );
+            for ( auto itr = str.rbegin(); itr != str.rend(); ++itr ) {
+                check( *itr >= 'A' && *itr <= 'Z', "only uppercase letters allowed in symbol_code string" );
+                value <<= 8;
+                value |= *itr;
+            }
+        }
+
+        constexpr uint64_t raw() const { return value; }
+        constexpr bool is_valid() const
+        {
+            uint64_t sym = value;
+            for ( int i = 0; i < 7; ++i ) {
+                const char c = static_cast<char>( sym & 0xFF );
+                if ( !( 'A' <= c && c <= 'Z' ) ) return false;
+                sym >>= 8;
+                if ( !( sym & 0xFF ) ) {
+                    do {
+                        sym >>= 8;
+                        if ( sym & 0xFF ) return false;
+                    } while ( ++i < 7 );
+                }
+            }
+            return true;
+        }
+
+        friend constexpr bool operator==( const symbol_code a, const symbol_code b ) { return a.value == b.value; }
+        friend constexpr bool operator!=( const symbol_code a, const symbol_code b ) { return a.value != b.value; }
+        friend constexpr bool operator<( const symbol_code a, const symbol_code b ) { return a.value < b.value; }
+    };
+
+    struct symbol {
+        uint64_t value = 0;
+
+        constexpr symbol() = default;
+        constexpr symbol( const symbol_code sc, const uint8_t precision ) : value( sc.raw() << 8 | precision ) {}
+
+        constexpr uint8_t precision() const { return value & 0xFF; }
+        constexpr symbol_code code() const { return symbol_code{ value >> 8 }; }
+        constexpr bool is_valid() const { return code().is_valid(); }
+
+        friend constexpr bool operator==( const symbol a, const symbol b ) { return a.value == b.value; }
+        friend constexpr bool operator!=( const symbol a, const symbol b ) { return a.value != b.value; }
+        friend constexpr bool operator<( const symbol a, const symbol b ) { return a.value < b.value; }
+    };
+
+    struct asset {
+        int64_t amount = 0;
+        eosio::symbol symbol;
+
+        bool is_valid() const { return amount >= -( 1LL << 62 ) + 1 && amount <= ( 1LL << 62 ) - 1 && symbol.is_valid(); }
+    };
+
+    struct extended_symbol {
+        eosio::symbol sym;
+        name contract;
+    };
+
+    struct extended_asset {
+        asset quantity;
+        name contract;
+    };
+}
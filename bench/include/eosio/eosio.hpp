@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * Minimal host shim of `eosio/eosio.hpp` used to build the Curve math kernel natively (x86-64 Linux)
+ *
+ * Provides only what `curve.hpp`, `sx.safemath` & `sx.rex` require:
+ *
+ * - `uint128_t` / `int128_t` types
+ * - `eosio::check` (throws `std::runtime_error` instead of aborting the transaction)
+ */
+
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+typedef unsigned __int128 uint128_t;
+typedef __int128 int128_t;
+
+namespace eosio {
+    inline void check( const bool pred, const char* msg ) {
+        if ( !pred ) throw std::runtime_error( msg );
+    }
+
+    inline void check( const bool pred, const std::string& msg ) {
+        if ( !pred ) throw std::runtime_error( msg );
+    }
+}
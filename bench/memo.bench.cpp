@@ -0,0 +1,184 @@
+// Native microbenchmark for memo parsing (`curve::parse_memo` & `curve::parse_memo_pair_ids`)
+//
+// Compares per memo:
+// - heap allocations (global `operator new` counter)
+// - ns/memo
+//
+// `split` parses with the previous `sx::utils::split` tokenizer (vector<string> copies,
+// `set<symbol_code>` duplicate check, memo passed by value), `view` with the `string_view`
+// tokenizer used by the contract (`sx::utils::split_view`, `next_token` & `parse_amount`).
+// Both reproduce the "swap", "swapout" & "deposit" branches of `curve::parse_memo`.
+//
+// ```bash
+// $ ./scripts/bench.sh [repetitions]
+// ```
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <eosio/asset.hpp>
+#include <sx.utils/utils.hpp>
+
+static uint64_t allocations = 0;
+
+void* operator new( size_t size )
+{
+    ++allocations;
+    if ( void* ptr = std::malloc( size ) ) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete( void* ptr ) noexcept { std::free( ptr ); }
+void operator delete( void* ptr, size_t ) noexcept { std::free( ptr ); }
+
+using eosio::check;
+using eosio::name;
+using eosio::symbol_code;
+using std::string;
+using std::string_view;
+using std::vector;
+
+struct memo_schema {
+    name                    action;
+    vector<symbol_code>     pair_ids;
+    int64_t                 min_return;
+    int64_t                 max_in;
+};
+
+static const vector<string> MEMOS = {
+    "swap,0,SXA",
+    "swap,990000,SXA-SXB-SXC",
+    "swapout,1100000,1000000,SXA-SXB",
+    "deposit,SXA,0",
+};
+
+// previous parser (`sx::utils::split` tokens)
+static vector<symbol_code> parse_pair_ids_split( const string memo )
+{
+    std::set<symbol_code> duplicates;
+    vector<symbol_code> pair_ids;
+    for ( const string& str : sx::utils::split( memo, "-" ) ) {
+        const symbol_code symcode = sx::utils::parse_symbol_code( str );
+        check( symcode.raw(), "invalid memo" );
+        pair_ids.push_back( symcode );
+        check( !duplicates.count( symcode ), "invalid duplicate `pair_ids`" );
+        duplicates.insert( symcode );
+    }
+    return pair_ids;
+}
+
+static memo_schema parse_memo_split( const string memo )
+{
+    const vector<string> parts = sx::utils::split( memo, "," );
+    check( parts.size() <= 4, "invalid memo" );
+
+    memo_schema result;
+    result.action = sx::utils::parse_name( parts[0] );
+    result.min_return = 0;
+    result.max_in = 0;
+
+    if ( result.action == name{"swap"} ) {
+        check( parts.size() == 3 && sx::utils::is_digit( string{ parts[1] } ), "invalid memo" );
+        result.min_return = std::stoll( parts[1] );
+        result.pair_ids = parse_pair_ids_split( parts[2] );
+    } else if ( result.action == name{"swapout"} ) {
+        check( parts.size() == 4 && sx::utils::is_digit( string{ parts[1] } ) && sx::utils::is_digit( string{ parts[2] } ), "invalid memo" );
+        result.max_in = std::stoll( parts[1] );
+        result.min_return = std::stoll( parts[2] );
+        result.pair_ids = parse_pair_ids_split( parts[3] );
+    } else if ( result.action == name{"deposit"} ) {
+        check( parts.size() == 3 && sx::utils::is_digit( string{ parts[2] } ), "invalid memo" );
+        result.pair_ids = parse_pair_ids_split( parts[1] );
+        result.min_return = std::stoll( parts[2] );
+    }
+    return result;
+}
+
+// current parser (`string_view` tokens, see `curve::parse_memo`)
+static vector<symbol_code> parse_pair_ids_view( const string_view memo )
+{
+    vector<symbol_code> pair_ids;
+    pair_ids.reserve( std::count( memo.begin(), memo.end(), '-' ) + 1 );
+    size_t pos = 0;
+    string_view token;
+    while ( sx::utils::next_token( memo, '-', pos, token ) ) {
+        const symbol_code symcode = sx::utils::parse_symbol_code( token );
+        check( symcode.raw(), "invalid memo" );
+        check( std::find( pair_ids.begin(), pair_ids.end(), symcode ) == pair_ids.end(), "invalid duplicate `pair_ids`" );
+        pair_ids.push_back( symcode );
+    }
+    return pair_ids;
+}
+
+static memo_schema parse_memo_view( const string& memo )
+{
+    std::array<string_view, 4> parts;
+    const size_t size = sx::utils::split_view( memo, ',', parts );
+    check( size <= 4, "invalid memo" );
+
+    memo_schema result;
+    result.action = sx::utils::parse_name( parts[0] );
+    result.min_return = 0;
+    result.max_in = 0;
+
+    if ( result.action == name{"swap"} ) {
+        check( size == 3, "invalid memo" );
+        result.min_return = sx::utils::parse_amount( parts[1] );
+        check( result.min_return >= 0, "invalid memo" );
+        result.pair_ids = parse_pair_ids_view( parts[2] );
+    } else if ( result.action == name{"swapout"} ) {
+        check( size == 4, "invalid memo" );
+        result.max_in = sx::utils::parse_amount( parts[1] );
+        result.min_return = sx::utils::parse_amount( parts[2] );
+        check( result.max_in > 0 && result.min_return > 0, "invalid memo" );
+        result.pair_ids = parse_pair_ids_view( parts[3] );
+    } else if ( result.action == name{"deposit"} ) {
+        check( size == 3, "invalid memo" );
+        result.pair_ids = parse_pair_ids_view( parts[1] );
+        result.min_return = sx::utils::parse_amount( parts[2] );
+        check( result.min_return >= 0, "invalid memo" );
+    }
+    return result;
+}
+
+template <typename F>
+static void measure( const char* label, const string& memo, const int repetitions, F parse, volatile uint64_t& sink )
+{
+    const uint64_t allocations_before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < repetitions; ++i ) {
+        const memo_schema result = parse( memo );
+        sink += result.min_return + result.pair_ids.size();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>( end - start ).count() / repetitions;
+    const double allocs = double( allocations - allocations_before ) / repetitions;
+    printf( "%-34s %-6s %8.1f ns/memo %6.1f allocs/memo\n", memo.c_str(), label, ns, allocs );
+}
+
+int main( int argc, char** argv )
+{
+    const int repetitions = argc > 1 ? std::atoi( argv[1] ) * 100 : 200000;
+    volatile uint64_t sink = 0;
+
+    // both parsers must agree
+    for ( const string& memo : MEMOS ) {
+        const memo_schema a = parse_memo_split( memo );
+        const memo_schema b = parse_memo_view( memo );
+        if ( a.action != b.action || a.pair_ids != b.pair_ids || a.min_return != b.min_return || a.max_in != b.max_in ) {
+            printf( "parser mismatch: %s\n", memo.c_str() );
+            return 1;
+        }
+    }
+
+    printf( "== memo parsing (%d repetitions) ==\n", repetitions );
+    for ( const string& memo : MEMOS ) {
+        measure( "split", memo, repetitions, parse_memo_split, sink );
+        measure( "view", memo, repetitions, parse_memo_view, sink );
+    }
+    return 0;
+}
@@ -2,10 +2,395 @@
 
 #include <sx.safemath/safemath.hpp>
 
+#include <array>
+#include <utility>
+#include <vector>
+
 using namespace eosio;
 
+// profiling hook for native benchmarks (see `bench/curve.bench.cpp`), compiles to nothing on-chain
+#ifndef CURVE_PROFILE
+#define CURVE_PROFILE( counter, value )
+#endif
+
 namespace Curve {
     const int MAX_ITERATIONS = 10;
+    const uint64_t PRICE_SCALE = 1000000000;
+    const uint8_t MAX_FEE = 100; // 1% (pips 1/100 of 1%)
+
+    /**
+     * ## STATIC `sqrt`
+     *
+     * Integer square root `floor(sqrt(n))` of a 64-bit value (Newton iteration with native 64-bit divisions)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t root = Curve::sqrt( uint64_t{ 99 } );
+     * // => 9
+     * ```
+     */
+    static uint64_t sqrt( const uint64_t n )
+    {
+        if ( n < 2 ) return n;
+
+        // initial guess 2^ceil(bits/2) >= sqrt(n), decreases monotonically to floor(sqrt(n))
+        uint64_t x = 1ULL << ((64 - __builtin_clzll( n ) + 1) / 2);
+        uint64_t y = (x + n / x) / 2;
+        while ( y < x ) {
+            x = y;
+            y = (x + n / x) / 2;
+        }
+        return x;
+    }
+
+    /**
+     * ## STATIC `sqrt`
+     *
+     * Integer square root `floor(sqrt(n))` of a 128-bit value
+     *
+     * Leading 64 bits are solved with native 64-bit divisions, which leaves a single 128-bit Newton step and an exact correction
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint128_t root = Curve::sqrt( uint128_t{ 1 } << 100 );
+     * // => 1125899906842624
+     * ```
+     */
+    static uint128_t sqrt( const uint128_t n )
+    {
+        if ( (n >> 64) == 0 ) return sqrt( static_cast<uint64_t>(n) );
+
+        // even shift so that the leading bits fit into 64 bits: sqrt(n) ~= sqrt(n >> shift) << (shift / 2)
+        const int bits = 128 - __builtin_clzll( static_cast<uint64_t>(n >> 64) );
+        const int shift = (bits - 64 + 1) & ~1;
+        const uint128_t x0 = static_cast<uint128_t>( sqrt( static_cast<uint64_t>(n >> shift) ) ) << (shift / 2);
+
+        // one Newton step from below lands within +2 of floor(sqrt(n)), sqrt(n) < 2^64 bounds the correction
+        CURVE_PROFILE( divisions, 1 );
+        uint128_t x = (x0 + n / x0) / 2;
+        if ( x > UINT64_MAX ) x = UINT64_MAX;
+        while ( x * x > n ) x--;
+        return x;
+    }
+
+    // number of significant bits of a 128-bit value
+    static int get_bits( const uint128_t n )
+    {
+        if ( n >> 64 ) return 128 - __builtin_clzll( static_cast<uint64_t>(n >> 64) );
+        return n ? 64 - __builtin_clzll( static_cast<uint64_t>(n) ) : 0;
+    }
+
+    // sum of reserves (unrolled for N coins)
+    template <size_t N, size_t... K>
+    static uint64_t get_sum( const std::array<uint64_t, N>& reserves, std::index_sequence<K...> )
+    {
+        uint64_t sum = 0;
+        ((sum = safemath::add( sum, reserves[K] )), ...);
+        return sum;
+    }
+
+    // D^(n+1) / (n^n * prod) (unrolled for N coins)
+    template <size_t N, size_t... K>
+    static uint128_t get_prod( const std::array<uint64_t, N>& reserves, const uint128_t D, std::index_sequence<K...> )
+    {
+        uint128_t prod = D;
+        ((prod = prod * D / (uint128_t(reserves[K]) * N)), ...);
+        return prod;
+    }
+
+    /**
+     * ## STATIC `get_invariant`
+     *
+     * Given N reserves and amplifier, returns the StableSwap invariant D
+     *
+     * Newton iteration starts from `D_hint` when provided (ex: invariant cached from previous trade),
+     * otherwise from the sum of reserves. An exact hint converges after a single confirming iteration.
+     *
+     * ### params
+     *
+     * - `{array<uint64_t, N>} reserves` - reserves
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint64_t} [D_hint=0]` - invariant D hint (0 to start from sum of reserves)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t D = Curve::get_invariant<3>( {1000000000, 1000000000, 1000000000}, 450 );
+     * // => 3000000000
+     * ```
+     */
+    template <size_t N>
+    static uint64_t get_invariant( const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint64_t D_hint = 0 )
+    {
+        static_assert( N >= 2, "curve.sx::get_invariant: requires at least 2 coins" );
+        eosio::check(amplifier > 0, "curve.sx::get_invariant: invalid amplifier");
+        for ( const uint64_t reserve : reserves ) {
+            eosio::check(reserve > 0, "curve.sx::get_invariant: insufficient liquidity");
+            eosio::check(reserve < (1LL << 62) - 1, "curve.sx::get_invariant: invalid reserves");
+        }
+
+        // calculate invariant D by solving quadratic equation:
+        // A * sum * n^n + D = A * D * n^n + D^(n+1) / (n^n * prod)
+        const uint64_t sum = get_sum( reserves, std::make_index_sequence<N>{} );
+        uint128_t D = D_hint ? D_hint : sum, D_prev = 0;
+        int i = MAX_ITERATIONS;
+        while ( D != D_prev && i--) {
+            CURVE_PROFILE( d_iterations, 1 );
+            CURVE_PROFILE( divisions, N + 1 );
+            const uint128_t prod1 = get_prod( reserves, D, std::make_index_sequence<N>{} );
+            D_prev = D;
+            check((uint64_t)(safemath::mul( amplifier, sum ) + prod1) == safemath::mul( amplifier, sum ) + prod1, "curve.sx::get_invariant: d1 overflow");
+            D = N * D * (safemath::mul(amplifier, sum) + prod1) / ((N * amplifier - 1) * D + (N + 1) * prod1);
+        }
+        check((uint64_t)D == D, "curve.sx::get_invariant: d2 overflow");
+
+        return D;
+    }
+
+    /**
+     * ## STATIC `get_invariant`
+     *
+     * Given reserves pair and amplifier, returns the StableSwap invariant D (2 coins)
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint64_t} reserve_out` - reserve output
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint64_t} [D_hint=0]` - invariant D hint (0 to start from sum of reserves)
+     *
+     * ### example
+     *
+     * ```c++
+     * // Inputs
+     * const uint64_t reserve_in = 3432247548;
+     * const uint64_t reserve_out = 6169362700;
+     * cont uint64_t amplifier = 450;
+     *
+     * // Calculation
+     * const uint64_t D = curve::get_invariant( reserve_in, reserve_out, amplifier );
+     * // => 9600668971
+     * ```
+     */
+    static uint64_t get_invariant( const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint64_t D_hint = 0 )
+    {
+        return get_invariant<2>( {reserve_in, reserve_out}, amplifier, D_hint );
+    }
+
+    // x^2 + b*x = c solved iteratively from x = x0 (decreases monotonically from above the root, ex: D)
+    static uint128_t solve_y_newton( const int128_t b, const uint128_t c, const uint128_t x0 )
+    {
+        uint128_t x = x0, x_prev = 0;
+        int i = MAX_ITERATIONS;
+        while ( x != x_prev && i--) {
+            CURVE_PROFILE( x_iterations, 1 );
+            CURVE_PROFILE( divisions, 1 );
+            x_prev = x;
+            x = (x * x + c) / (2 * x + b);
+        }
+        return x;
+    }
+
+    // x^2 + b*x = c solved in closed form: x = floor((isqrt(b^2 + 4c) - b) / 2), see `get_y`
+    static uint128_t solve_y( const int128_t b, const uint128_t c, const uint128_t x0 )
+    {
+        // |b| < 2^64 => b^2 fits in 128 bits
+        const uint128_t b_abs = b < 0 ? -b : b;
+        if ( b_abs >> 64 ) return solve_y_newton( b, c, x0 );
+        const uint128_t b2 = b_abs * b_abs;
+        if ( c > (~uint128_t(0) - b2) / 4 ) return solve_y_newton( b, c, x0 );
+
+        // isqrt(b^2 + 4c) >= |b| => x >= 0
+        const uint128_t x = static_cast<uint128_t>( (int128_t) sqrt( b2 + 4 * c ) - b ) / 2;
+
+        // confirm fixed point: x = (x^2 + c) / (2x + b)
+        CURVE_PROFILE( divisions, 1 );
+        if ( (int128_t) (2 * x) + b <= 0 || (x * x + c) / (2 * x + b) != x ) return solve_y_newton( b, c, x0 );
+        return x;
+    }
+
+    // coefficients of x^2 + b*x = c for output reserve `j` (unrolled for N coins)
+    template <size_t N, size_t... K>
+    static void get_y_coefficients( const std::array<uint64_t, N>& reserves, const size_t j, const uint128_t D, const uint64_t amplifier, int128_t& b, uint128_t& c, std::index_sequence<K...> )
+    {
+        // x^2 + x * (sum' - (An^n - 1) * D / (An^n)) = D ^ (n + 1) / (n^(2n) * prod' * A)
+        uint64_t sum = 0;
+        c = D;
+        ((K != j ? (sum = safemath::add( sum, reserves[K] ), c = c * D / (uint128_t(reserves[K]) * N)) : c), ...);
+        b = (int128_t) (sum + (D / (amplifier * N))) - (int128_t) D;
+        c = c * D / (amplifier * N * N);
+        CURVE_PROFILE( divisions, N + 1 );
+    }
+
+    /**
+     * ## STATIC `get_deposit_invariant`
+     *
+     * Given deposit amounts, N reserves, amplifier and fee, returns the invariant D of reserves after an imbalanced deposit,
+     * net of the imbalance fee charged on each reserve's difference to a balanced (proportional) deposit
+     *
+     * Issued liquidity is proportional to `D2 - D0` (ex: `rex::issue( D2 - D0, D0, supply )`), a balanced deposit pays no fee
+     *
+     * ### params
+     *
+     * - `{array<uint64_t, N>} amounts` - deposit amounts (0 for single-sided deposits)
+     * - `{array<uint64_t, N>} reserves` - reserves before deposit
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%), imbalance fee is `fee * N / (4 * (N - 1))`
+     * - `{uint64_t} D0` - invariant D of reserves before deposit
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t D0 = Curve::get_invariant( reserve0, reserve1, amplifier );
+     * const uint64_t D2 = Curve::get_deposit_invariant<2>( {amount0, 0}, {reserve0, reserve1}, amplifier, fee, D0 );
+     * ```
+     */
+    template <size_t N>
+    static uint64_t get_deposit_invariant( const std::array<uint64_t, N>& amounts, const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint8_t fee, const uint64_t D0 )
+    {
+        eosio::check(D0 > 0, "curve.sx::get_deposit_invariant: invalid invariant");
+
+        std::array<uint64_t, N> reserves_new;
+        for ( size_t k = 0; k < N; ++k ) reserves_new[k] = safemath::add( reserves[k], amounts[k] );
+        const uint64_t D1 = get_invariant( reserves_new, amplifier, D0 );
+        eosio::check(D1 > D0, "curve.sx::get_deposit_invariant: invariant must increase");
+
+        // imbalance fee on the difference to the ideal reserve of a proportional deposit
+        for ( size_t k = 0; k < N; ++k ) {
+            const uint128_t ideal = uint128_t(D1) * reserves[k] / D0;
+            const uint128_t difference = ideal > reserves_new[k] ? ideal - reserves_new[k] : reserves_new[k] - ideal;
+            reserves_new[k] -= static_cast<uint64_t>( difference * fee * N / (10000 * 4 * (N - 1)) );
+        }
+        return get_invariant( reserves_new, amplifier, D1 );
+    }
+
+    /**
+     * ## STATIC `get_y`
+     *
+     * Given the new reserves (input reserve includes amount input), invariant D and amplifier, returns the new output reserve `j`
+     * using the closed-form root of `x^2 + b*x = c`: `x = floor((isqrt(b^2 + 4c) - b) / 2)`
+     *
+     * Result is the fixed point of `get_y_newton` iteration, falls back to `get_y_newton` when the discriminant exceeds
+     * 128 bits or when the fixed point does not exist (iteration alternates between `x` and `x + 1`)
+     *
+     * ### params
+     *
+     * - `{array<uint64_t, N>} reserves` - new reserves (reserve `j` is ignored)
+     * - `{size_t} j` - output reserve index
+     * - `{uint128_t} D` - invariant D
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint128_t} [x_hint=0]` - Newton fallback starting point, must not be below the result (0 to start from `D`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint128_t D = Curve::get_invariant<3>( reserves, amplifier );
+     * reserves[0] += amount_in;
+     * const uint128_t reserve_out_new = Curve::get_y<3>( reserves, 2, D, amplifier );
+     * ```
+     */
+    template <size_t N>
+    static uint128_t get_y( const std::array<uint64_t, N>& reserves, const size_t j, const uint128_t D, const uint64_t amplifier, const uint128_t x_hint = 0 )
+    {
+        int128_t b;
+        uint128_t c;
+        get_y_coefficients( reserves, j, D, amplifier, b, c, std::make_index_sequence<N>{} );
+        return solve_y( b, c, x_hint ? x_hint : D );
+    }
+
+    /**
+     * ## STATIC `get_y_newton`
+     *
+     * Same as `get_y`, solving the quadratic equation iteratively from `x = D`
+     */
+    template <size_t N>
+    static uint128_t get_y_newton( const std::array<uint64_t, N>& reserves, const size_t j, const uint128_t D, const uint64_t amplifier )
+    {
+        int128_t b;
+        uint128_t c;
+        get_y_coefficients( reserves, j, D, amplifier, b, c, std::make_index_sequence<N>{} );
+        return solve_y_newton( b, c, D );
+    }
+
+    /**
+     * ## STATIC `get_y`
+     *
+     * Given the new input reserve, invariant D and amplifier, returns the new output reserve (2 coins)
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve_in` - new reserve input (reserve input + amount input)
+     * - `{uint128_t} D` - invariant D
+     * - `{uint64_t} amplifier` - amplifier
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint128_t D = Curve::get_invariant( reserve_in, reserve_out, amplifier );
+     * const uint128_t reserve_out_new = Curve::get_y( reserve_in + amount_in, D, amplifier );
+     * ```
+     */
+    static uint128_t get_y( const uint64_t reserve_in, const uint128_t D, const uint64_t amplifier )
+    {
+        return get_y<2>( {reserve_in, 0}, 1, D, amplifier );
+    }
+
+    /**
+     * ## STATIC `get_y_newton`
+     *
+     * Given the new input reserve, invariant D and amplifier, returns the new output reserve by solving quadratic equation iteratively (2 coins)
+     */
+    static uint128_t get_y_newton( const uint64_t reserve_in, const uint128_t D, const uint64_t amplifier )
+    {
+        return get_y_newton<2>( {reserve_in, 0}, 1, D, amplifier );
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Given an input amount, N reserves and amplifier, returns the output amount of reserve `j` for input into reserve `i`
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_in` - amount input
+     * - `{size_t} i` - input reserve index
+     * - `{size_t} j` - output reserve index
+     * - `{array<uint64_t, N>} reserves` - reserves
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_out = Curve::get_amount_out<3>( 100000, 0, 2, {3432247548, 6169362700, 5000000000}, 450, 4 );
+     * ```
+     */
+    template <size_t N>
+    static uint64_t get_amount_out( const uint64_t amount_in, const size_t i, const size_t j, const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
+    {
+        eosio::check(amount_in > 0, "curve.sx::get_amount_out: insufficient input amount");
+        eosio::check(amplifier > 0, "curve.sx::get_amount_out: invalid amplifier");
+        eosio::check(i < N && j < N && i != j, "curve.sx::get_amount_out: invalid reserve index");
+        for ( const uint64_t reserve : reserves ) {
+            eosio::check(reserve > 0, "curve.sx::get_amount_out: insufficient liquidity");
+            eosio::check(reserve < (1LL << 62) - 1, "curve.sx::get_amount_out: invalid reserves");
+        }
+
+        const uint128_t D = get_invariant( reserves, amplifier, D_hint );
+
+        // calculate x - new value for reserve_out
+        std::array<uint64_t, N> reserves_new = reserves;
+        reserves_new[i] += amount_in;
+        const uint128_t x = get_y( reserves_new, j, D, amplifier );
+        check(reserves[j] > x, "curve.sx::get_amount_out: insufficient reserve out");
+        const uint64_t amount_out = reserves[j] - (uint64_t)x;
+
+        return amount_out - fee * amount_out / 10000;
+    }
+
     /**
      * ## STATIC `get_amount_out`
      *
@@ -20,6 +405,7 @@ namespace Curve {
      * - `{uint64_t} reserve_out` - reserve output
      * - `{uint64_t} amplifier` - amplifier
      * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
      *
      * ### example
      *
@@ -36,40 +422,295 @@ namespace Curve {
      * // => 100110
      * ```
      */
-    static uint64_t get_amount_out( const uint64_t amount_in, const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint8_t fee )
+    static uint64_t get_amount_out( const uint64_t amount_in, const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
     {
-        eosio::check(amount_in > 0, "curve.sx::get_amount_out: insufficient input amount");
-        eosio::check(amplifier > 0, "curve.sx::get_amount_out: invalid amplifier");
-        eosio::check(reserve_in > 0 && reserve_out > 0, "curve.sx::get_amount_out: insufficient liquidity");
-        eosio::check(reserve_in < (1LL << 62) - 1 && reserve_out < (1LL << 62) - 1, "curve.sx::get_amount_out: invalid reserves");
+        return get_amount_out<2>( amount_in, 0, 1, {reserve_in, reserve_out}, amplifier, fee, D_hint );
+    }
 
-        // calculate invariant D by solving quadratic equation:
-        // A * sum * n^n + D = A * D * n^n + D^(n+1) / (n^n * prod), where n==2
-        const uint64_t sum = reserve_in + reserve_out;
-        uint128_t D = sum, D_prev = 0;
-        int i = MAX_ITERATIONS;
-        while ( D != D_prev && i--) {
-            uint128_t prod1 = D * D / (reserve_in * 2) * D / (reserve_out * 2);
-            D_prev = D;
-            check((uint64_t)(safemath::mul( amplifier, sum ) + prod1) == safemath::mul( amplifier, sum ) + prod1, "curve.sx::get_amount_out: d1 overflow");
-            D = 2 * D * (safemath::mul(amplifier, sum) + prod1) / ((2 * amplifier - 1) * D + 3 * prod1);
+    /**
+     * ## STATIC `get_marginal_price`
+     *
+     * Marginal rate of `reserve1` per unit of `reserve0` at the exact invariant D of reserves (no solve, see `get_spot_price`), ex: both directions priced from one D
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve0` - reserve priced (x)
+     * - `{uint64_t} reserve1` - reserve quoted (y)
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint64_t} D` - invariant D of reserves (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t D = Curve::get_invariant( 3432247548, 6169362700, 450 );
+     * const uint64_t price = Curve::get_marginal_price( 3432247548, 6169362700, 450, D );
+     * // => 1001497755 (1.001497755)
+     * ```
+     */
+    static uint64_t get_marginal_price( const uint64_t reserve0, const uint64_t reserve1, const uint64_t amplifier, const uint64_t D )
+    {
+        // D^3 / (4xy) & Ann
+        const uint128_t prod = get_prod<2>( {reserve0, reserve1}, D, std::make_index_sequence<2>{} );
+        const uint128_t Ann = uint128_t(amplifier) * 2;
+
+        // numerator & denominator factors are kept below 2^66 (65+ significant bits) so that products fit in 128 bits
+        uint128_t a = Ann * reserve0 + prod;
+        uint128_t b = Ann * reserve1 + prod;
+        const int shift_a = std::max( get_bits( a ) - 66, 0 );
+        const int shift_b = std::max( get_bits( b ) - 66, 0 );
+        uint128_t num = (a >> shift_a) * reserve1;
+        uint128_t den = (b >> shift_b) * reserve0;
+
+        // price = num * 2^shift * PRICE_SCALE / den, with num normalized to 97 bits (num * PRICE_SCALE < 2^127)
+        int shift = shift_a - shift_b + get_bits( num ) - 97;
+        num = get_bits( num ) > 97 ? num >> (get_bits( num ) - 97) : num << (97 - get_bits( num ));
+        if ( shift >= 0 ) {
+            check(get_bits( den ) > shift, "curve.sx::get_marginal_price: price out of range");
+            den >>= shift;
+        } else {
+            const int room = std::min( -shift, 127 - get_bits( den ) );
+            den <<= room;
+            num = -shift - room < 128 ? num >> (-shift - room) : 0;
         }
+        CURVE_PROFILE( divisions, 1 );
+        const uint128_t price = num * PRICE_SCALE / den;
+        check(price > 0 && (uint64_t)price == price, "curve.sx::get_marginal_price: price out of range");
 
-        // calculate x - new value for reserve_out by solving quadratic equation iteratively:
-        // x^2 + x * (sum' - (An^n - 1) * D / (An^n)) = D ^ (n + 1) / (n^(2n) * prod' * A), where n==2
-        // x^2 + b*x = c
-        check((uint64_t)D == D, "curve.sx::get_amount_out: d2 overflow");
-        const int128_t b = (int128_t) ((reserve_in + amount_in) + (D / (amplifier * 2))) - (int128_t) D;
-        const uint128_t c = D * D / ((reserve_in + amount_in) * 2) * D / (amplifier * 4);
-        uint128_t x = D, x_prev = 0;
-        i = MAX_ITERATIONS;
-        while ( x != x_prev && i--) {
-            x_prev = x;
-            x = (x * x + c) / (2 * x + b);
+        return price;
+    }
+
+    /**
+     * ## STATIC `get_spot_price`
+     *
+     * Given reserves pair and amplifier, returns the marginal rate `-dy/dx` of `reserve1` per unit of `reserve0` (before fees),
+     * scaled by `PRICE_SCALE`
+     *
+     * Implicit derivative of the invariant `Ann * (x + y) + D = Ann * D + D^3 / (4xy)` at current D:
+     * `-dy/dx = y * (Ann * x + D^3 / (4xy)) / (x * (Ann * y + D^3 / (4xy)))`, within 1 unit of PRICE_SCALE (integer only, 65+ significant bits per factor)
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve0` - reserve priced (x)
+     * - `{uint64_t} reserve1` - reserve quoted (y)
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t price = Curve::get_spot_price( 3432247548, 6169362700, 450 );
+     * // => 1001497755 (1.001497755)
+     * ```
+     */
+    static uint64_t get_spot_price( const uint64_t reserve0, const uint64_t reserve1, const uint64_t amplifier, const uint64_t D_hint = 0 )
+    {
+        return get_marginal_price( reserve0, reserve1, amplifier, get_invariant( reserve0, reserve1, amplifier, D_hint ) );
+    }
+
+    /**
+     * ## STATIC `get_depth_ladder`
+     *
+     * Given ascending input amounts, N reserves and amplifier, returns the output amount of reserve `j` for each input into reserve `i`
+     * (output-vs-input curve of the pool, ex: 1, 2, 5, 10... up to 50% of reserve `i`)
+     *
+     * Invariant D is solved once for all points, each point's output reserve solver is seeded from the previous point's `x`
+     * (larger input => smaller `x`, see `get_y`). Each point matches `get_amount_out` (within 1 when the fixed point does not exist)
+     *
+     * ### params
+     *
+     * - `{vector<uint64_t>} amounts_in` - ascending input amounts
+     * - `{size_t} i` - input reserve index
+     * - `{size_t} j` - output reserve index
+     * - `{array<uint64_t, N>} reserves` - reserves
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const std::vector<uint64_t> amounts_out = Curve::get_depth_ladder<2>( {100000, 200000, 500000}, 0, 1, {3432247548, 6169362700}, 450, 4 );
+     * ```
+     */
+    template <size_t N>
+    static std::vector<uint64_t> get_depth_ladder( const std::vector<uint64_t>& amounts_in, const size_t i, const size_t j, const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
+    {
+        eosio::check(amplifier > 0, "curve.sx::get_depth_ladder: invalid amplifier");
+        eosio::check(i < N && j < N && i != j, "curve.sx::get_depth_ladder: invalid reserve index");
+        for ( const uint64_t reserve : reserves ) {
+            eosio::check(reserve > 0, "curve.sx::get_depth_ladder: insufficient liquidity");
+            eosio::check(reserve < (1LL << 62) - 1, "curve.sx::get_depth_ladder: invalid reserves");
         }
-        check(reserve_out > x, "curve.sx::get_amount_out: insufficient reserve out");
-        const uint64_t amount_out = reserve_out - (uint64_t)x;
 
-        return amount_out - fee * amount_out / 10000;
+        const uint128_t D = get_invariant( reserves, amplifier, D_hint );
+
+        std::vector<uint64_t> amounts_out;
+        amounts_out.reserve( amounts_in.size() );
+        std::array<uint64_t, N> reserves_new = reserves;
+        uint64_t amount_prev = 0;
+        uint128_t x = 0;
+        for ( const uint64_t amount_in : amounts_in ) {
+            eosio::check(amount_in > amount_prev, "curve.sx::get_depth_ladder: input amounts must be ascending");
+
+            // calculate x - new value for reserve_out, seeded from previous point
+            reserves_new[i] = reserves[i] + amount_in;
+            x = get_y( reserves_new, j, D, amplifier, x );
+            check(reserves[j] > x, "curve.sx::get_depth_ladder: insufficient reserve out");
+            const uint64_t amount_out = reserves[j] - (uint64_t)x;
+
+            amounts_out.push_back( amount_out - fee * amount_out / 10000 );
+            amount_prev = amount_in;
+        }
+        return amounts_out;
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Given an output amount of reserve `j`, N reserves and amplifier, returns the input amount into reserve `i` required to receive at least `amount_out`
+     * Inverse of `get_amount_out`: `get_amount_out( get_amount_in( amount_out, ... ), ... ) >= amount_out`
+     *
+     * Invariant is solved once for the new input reserve (symmetric in reserves), the result is then confirmed with the
+     * forward output reserve solver and rounded up when needed
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_out` - amount output
+     * - `{size_t} i` - input reserve index
+     * - `{size_t} j` - output reserve index
+     * - `{array<uint64_t, N>} reserves` - reserves
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     */
+    template <size_t N>
+    static uint64_t get_amount_in( const uint64_t amount_out, const size_t i, const size_t j, const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
+    {
+        eosio::check(amount_out > 0, "curve.sx::get_amount_in: insufficient output amount");
+        eosio::check(amplifier > 0, "curve.sx::get_amount_in: invalid amplifier");
+        eosio::check(i < N && j < N && i != j, "curve.sx::get_amount_in: invalid reserve index");
+        for ( const uint64_t reserve : reserves ) {
+            eosio::check(reserve > 0, "curve.sx::get_amount_in: insufficient liquidity");
+            eosio::check(reserve < (1LL << 62) - 1, "curve.sx::get_amount_in: invalid reserves");
+        }
+        eosio::check(fee <= MAX_FEE, "curve.sx::get_amount_in: invalid fee");
+
+        // smallest output before trade fee where `out - fee * out / 10000 >= amount_out`
+        uint64_t out = static_cast<uint64_t>( (uint128_t(amount_out) * 10000 + (10000 - fee) - 1) / (10000 - fee) );
+        if ( out > 1 && (out - 1) - fee * (out - 1) / 10000 >= amount_out ) out--;
+        check(reserves[j] > out, "curve.sx::get_amount_in: insufficient reserve out");
+
+        const uint128_t D = get_invariant( reserves, amplifier, D_hint );
+
+        // calculate x - new value for reserve_in given new reserve_out
+        std::array<uint64_t, N> reserves_new = reserves;
+        reserves_new[j] -= out;
+        const uint64_t y = reserves_new[j];
+        const uint128_t x = get_y( reserves_new, i, D, amplifier );
+        check(x < (1LL << 62) - 1, "curve.sx::get_amount_in: invalid reserves");
+        uint64_t amount_in = x > reserves[i] ? static_cast<uint64_t>(x) - reserves[i] : 1;
+
+        // round up until forward output reserve reaches `y`
+        int k = MAX_ITERATIONS;
+        while ( true ) {
+            reserves_new[i] = reserves[i] + amount_in;
+            if ( get_y( reserves_new, j, D, amplifier ) <= y ) break;
+            check(k-- > 0, "curve.sx::get_amount_in: failed to converge");
+            amount_in++;
+        }
+
+        return amount_in;
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Given an output amount, reserves pair and amplifier, returns the input amount required to receive at least `amount_out`
+     * Inverse of `get_amount_out`: `get_amount_out( get_amount_in( amount_out, ... ), ... ) >= amount_out`
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_out` - amount output
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint64_t} reserve_out` - reserve output
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * // Inputs
+     * const uint64_t amount_out = 100110;
+     * const uint64_t reserve_in = 3432247548;
+     * const uint64_t reserve_out = 6169362700;
+     * cont uint64_t amplifier = 450;
+     * const uint8_t fee = 4;
+     *
+     * // Calculation
+     * const uint64_t amount_in = curve::get_amount_in( amount_out, reserve_in, reserve_out, amplifier, fee );
+     * // => 100000
+     * ```
+     */
+    static uint64_t get_amount_in( const uint64_t amount_out, const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
+    {
+        return get_amount_in<2>( amount_out, 0, 1, {reserve_in, reserve_out}, amplifier, fee, D_hint );
+    }
+
+    /**
+     * ## STATIC `get_withdraw_one_out`
+     *
+     * Given liquidity to withdraw, liquidity supply, N reserves, amplifier and fee, returns the output amount of reserve `j`
+     * when the whole withdrawal is paid out in a single reserve
+     *
+     * Invariant is reduced pro rata to `D1 = D0 - D0 * liquidity / supply` and solved for reserve `j` (see `get_y`),
+     * imbalance fee is charged on each reserve's difference to a balanced (proportional) withdrawal
+     *
+     * ### params
+     *
+     * - `{uint64_t} liquidity` - liquidity to withdraw
+     * - `{uint64_t} supply` - liquidity supply (must be greater than `liquidity`)
+     * - `{size_t} j` - output reserve index
+     * - `{array<uint64_t, N>} reserves` - reserves
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%), imbalance fee is `fee * N / (4 * (N - 1))`
+     * - `{uint64_t} [D_hint=0]` - invariant D of reserves, ex: cached from previous trade (see `get_invariant`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_out = Curve::get_withdraw_one_out<2>( 100000, 9601610248, 0, {3432247548, 6169362700}, 450, 4 );
+     * ```
+     */
+    template <size_t N>
+    static uint64_t get_withdraw_one_out( const uint64_t liquidity, const uint64_t supply, const size_t j, const std::array<uint64_t, N>& reserves, const uint64_t amplifier, const uint8_t fee, const uint64_t D_hint = 0 )
+    {
+        eosio::check(liquidity > 0, "curve.sx::get_withdraw_one_out: insufficient liquidity amount");
+        eosio::check(liquidity < supply, "curve.sx::get_withdraw_one_out: cannot withdraw entire supply into a single reserve");
+        eosio::check(amplifier > 0, "curve.sx::get_withdraw_one_out: invalid amplifier");
+        eosio::check(j < N, "curve.sx::get_withdraw_one_out: invalid reserve index");
+        for ( const uint64_t reserve : reserves ) {
+            eosio::check(reserve > 0, "curve.sx::get_withdraw_one_out: insufficient liquidity");
+            eosio::check(reserve < (1LL << 62) - 1, "curve.sx::get_withdraw_one_out: invalid reserves");
+        }
+
+        const uint64_t D0 = get_invariant( reserves, amplifier, D_hint );
+        const uint64_t D1 = D0 - static_cast<uint64_t>( uint128_t(D0) * liquidity / supply );
+        eosio::check(D1 > 0, "curve.sx::get_withdraw_one_out: insufficient liquidity");
+
+        // imbalance fee on the difference to the ideal reserve of a proportional withdrawal
+        const uint128_t y = get_y( reserves, j, D1, amplifier );
+        std::array<uint64_t, N> reserves_reduced = reserves;
+        for ( size_t k = 0; k < N; ++k ) {
+            const uint128_t ideal = uint128_t(reserves[k]) * D1 / D0;
+            const uint128_t current = k == j ? y : reserves[k];
+            const uint128_t difference = ideal > current ? ideal - current : current - ideal;
+            reserves_reduced[k] -= static_cast<uint64_t>( difference * fee * N / (10000 * 4 * (N - 1)) );
+        }
+
+        // calculate x - new value for reserve_out, round down by 1 in favor of remaining liquidity providers
+        const uint128_t x = get_y( reserves_reduced, j, D1, amplifier );
+        check(reserves_reduced[j] > x + 1, "curve.sx::get_withdraw_one_out: insufficient reserve out");
+        return reserves_reduced[j] - static_cast<uint64_t>(x) - 1;
     }
 }
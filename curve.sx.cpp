@@ -5,6 +5,12 @@
 
 #include "curve.sx.hpp"
 #include "src/actions.cpp"
+#include "src/pools.cpp"
+#include "src/quotes.cpp"
+#include "src/routes.cpp"
+#include "src/batch.cpp"
+#include "src/observations.cpp"
+#include "src/orders.cpp"
 
 namespace sx {
 
@@ -19,7 +25,7 @@ void curve::on_transfer( const name from, const name to, const asset quantity, c
 
     // tables
     curve::config_table _config( get_self(), get_self().value );
-    curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::pools_table _pools( get_self(), get_self().value );
 
     // config
     check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
@@ -35,29 +41,61 @@ void curve::on_transfer( const name from, const name to, const asset quantity, c
     // user input params
     const auto parsed_memo = parse_memo( memo );
     const extended_asset ext_in = { quantity, get_first_receiver() };
-    const bool is_liquidity = _pairs.find( quantity.symbol.code().raw() ) != _pairs.end();
 
-    // add liquidity (memo required => "deposit,<pair_id>")
+    // add liquidity (memo required => "deposit,<pair_id>" or "deposit,<pool_id>")
+    // single transaction imbalanced deposit (memo required => "deposit,<pair_id>,<min_return>")
     if ( parsed_memo.action == "deposit"_n ) {
-        add_liquidity( from, parsed_memo.pair_ids[0], ext_in );
+        const bool is_pool = _pools.find( parsed_memo.pair_ids[0].raw() ) != _pools.end();
+        if ( parsed_memo.instant ) {
+            check( !is_pool, "curve.sx::on_transfer: single transaction deposit is only available for pairs");
+            add_liquidity_instant( from, parsed_memo.pair_ids[0], ext_in, parsed_memo.min_return );
+        }
+        else if ( is_pool ) add_pool_liquidity( from, parsed_memo.pair_ids[0], ext_in );
+        else add_liquidity( from, parsed_memo.pair_ids[0], ext_in );
+
+    // swap convert (memo required => "swap,<min_return>,<pair_ids>" or "swap,<min_return>,auto,<symcode_out>")
+    // split across routes (memo required => "swap,<min_return>,<pair_ids>:<weight>|<pair_ids>:<weight>" or "swap,<min_return>,<pair_ids>|<pair_ids>")
+    } else if ( parsed_memo.action == "swap"_n && parsed_memo.legs.size() ) {
+        convert_split( from, ext_in, parsed_memo.legs, parsed_memo.weights, parsed_memo.min_return );
 
-    // swap convert (memo required => "swap,<min_return>,<pair_ids>")
     } else if ( parsed_memo.action == "swap"_n) {
-        convert( from, ext_in, parsed_memo.pair_ids, parsed_memo.min_return );
+        const vector<symbol_code> pair_ids = parsed_memo.pair_ids.size() ? parsed_memo.pair_ids : find_route( ext_in, parsed_memo.symcode_out );
+        convert( from, ext_in, pair_ids, parsed_memo.min_return );
 
-    // withdraw liquidity (no memo required)
-    } else if ( is_liquidity ) {
-        withdraw_liquidity( from, ext_in );
+    // swap convert exact output (memo required => "swapout,<max_in>,<amount_out>,<pair_ids>")
+    } else if ( parsed_memo.action == "swapout"_n) {
+        convert_out( from, ext_in, parsed_memo.pair_ids, parsed_memo.min_return, parsed_memo.max_in );
+
+    // swap convert via N coin pool (memo required => "swappool,<min_return>,<pool_id>,<symcode_out>")
+    } else if ( parsed_memo.action == "swappool"_n) {
+        convert_pool( from, ext_in, parsed_memo.pair_ids[0], parsed_memo.symcode_out, parsed_memo.min_return );
+
+    // deposit balance for `batchswap` orders (memo required => "batch")
+    // only reserves of existing pairs are accepted (balance rows are paid by contract)
+    } else if ( parsed_memo.action == "batch"_n) {
+        check( get_pair_ids( ext_in.get_extended_symbol() ).size(), "curve.sx::on_transfer: \"batch\" deposit must be a reserve of an existing pair");
+        add_balance( from, ext_in );
+
+    // withdraw liquidity into a single reserve (memo required => "withdrawone,<symbol>,<min_return>")
+    } else if ( parsed_memo.action == "withdrawone"_n) {
+        withdraw_liquidity_one( from, ext_in, parsed_memo.symcode_out, parsed_memo.min_return );
 
+    // withdraw liquidity (no memo required)
     } else {
-        check( false, ERROR_INVALID_MEMO );
+        curve::pairs_table _pairs( get_self(), get_self().value );
+        if ( _pairs.find( quantity.symbol.code().raw() ) != _pairs.end() ) withdraw_liquidity( from, ext_in );
+        else if ( _pools.find( quantity.symbol.code().raw() ) != _pools.end() ) withdraw_pool_liquidity( from, ext_in );
+        else check( false, ERROR_INVALID_MEMO );
     }
 }
 
 void curve::convert( const name owner, const extended_asset ext_in, const vector<symbol_code> pair_ids, const int64_t min_return )
 {
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
+
     // execute the trade by updating all involved pools
-    const extended_asset out = apply_trade( owner, ext_in, pair_ids );
+    const extended_asset out = apply_trade( owner, ext_in, pair_ids, config );
 
     // enforce minimum return (slippage protection)
     check(out.quantity.amount != 0 && out.quantity.amount >= min_return, "curve.sx::convert: invalid minimum return");
@@ -66,19 +104,66 @@ void curve::convert( const name owner, const extended_asset ext_in, const vector
     transfer( get_self(), owner, out, "curve.sx: swap token" );
 }
 
-extended_asset curve::apply_trade( const name owner, const extended_asset ext_quantity, const vector<symbol_code> pair_ids )
+void curve::convert_out( const name owner, const extended_asset ext_in, const vector<symbol_code> pair_ids, const int64_t amount_out, const int64_t max_in )
 {
     curve::pairs_table _pairs( get_self(), get_self().value );
     curve::config_table _config( get_self(), get_self().value );
-    auto config = _config.get();
+    const auto config = _config.get();
+
+    // output symbol of swap path
+    vector<const pairs_row*> path;
+    extended_symbol ext_sym = ext_in.get_extended_symbol();
+    for ( const symbol_code pair_id : pair_ids ) {
+        const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::convert_out: `pair_id` does not exist");
+        check( pairs.reserve0.get_extended_symbol() == ext_sym || pairs.reserve1.get_extended_symbol() == ext_sym, "curve.sx::convert_out: incoming currency/reserves contract mismatch");
+        ext_sym = pairs.reserve0.get_extended_symbol() == ext_sym ? pairs.reserve1.get_extended_symbol() : pairs.reserve0.get_extended_symbol();
+        path.push_back( &pairs );
+    }
+
+    // calculate required input (slippage protection), reverse order from last pool
+    asset quantity = { amount_out, ext_sym.get_symbol() };
+    for ( auto itr = path.rbegin(); itr != path.rend(); ++itr ) {
+        quantity = get_amount_in( quantity, **itr, config, get_amplifier( **itr ) );
+    }
+    const extended_asset in = { quantity, ext_in.contract };
+    check( in.quantity.amount <= max_in, "curve.sx::convert_out: required input exceeds maximum input");
+    check( in <= ext_in, "curve.sx::convert_out: insufficient input amount");
+
+    // execute the trade by updating all involved pools
+    const extended_asset out = apply_trade( owner, in, pair_ids, config );
+    check( out.quantity.amount >= amount_out, "curve.sx::convert_out: invalid amount out");
+
+    // transfer amount to owner & refund unused input
+    transfer( get_self(), owner, out, "curve.sx: swap token" );
+    if ( ext_in.quantity.amount > in.quantity.amount ) transfer( get_self(), owner, ext_in - in, "curve.sx: refund" );
+}
+
+extended_asset curve::apply_trade( const name owner, const extended_asset ext_quantity, const vector<symbol_code> pair_ids, const config_row& config )
+{
+    vector<trade_record> trades;
+    const extended_asset ext_out = apply_trade( ext_quantity, pair_ids, config, trades );
+
+    // trade log (single inline action for all hops)
+    curve::tradelog_action tradelog( get_self(), { get_self(), "active"_n });
+    tradelog.send( owner, "swap"_n, trades, config.stats_account.value_or() );
+
+    return ext_out;
+}
+
+// execute trade along `pair_ids`, appending per-hop records to `trades` (logged by caller)
+extended_asset curve::apply_trade( const extended_asset ext_quantity, const vector<symbol_code> pair_ids, const config_row& config, vector<trade_record>& trades )
+{
+    curve::pairs_table _pairs( get_self(), get_self().value );
 
     // initial quantities
     extended_asset ext_out;
     extended_asset ext_in = ext_quantity;
 
     // iterate over each liquidity pool per each `pair_id` provided in swap memo
+    // pair rows are read once per hop (ramp is stored inline), config once per trade
     for ( const symbol_code pair_id : pair_ids ) {
         const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::apply_trade: `pair_id` does not exist");
+        const uint64_t amplifier = get_amplifier( pairs );
         const bool is_in = pairs.reserve0.quantity.symbol == ext_in.quantity.symbol;
         const extended_asset reserve_in = is_in ? pairs.reserve0 : pairs.reserve1;
         const extended_asset reserve_out = is_in ? pairs.reserve1 : pairs.reserve0;
@@ -87,45 +172,39 @@ extended_asset curve::apply_trade( const name owner, const extended_asset ext_qu
         check(reserve_in.get_extended_symbol() == ext_in.get_extended_symbol(), "curve.sx::apply_trade: incoming currency/reserves contract mismatch");
         check(reserve_in.quantity.amount != 0 && reserve_out.quantity.amount != 0, "curve.sx::apply_trade: empty pool reserves");
 
-        // calculate out
-        ext_out = { get_amount_out( ext_in.quantity, pair_id ), reserve_out.contract };
-
-        // send protocol fees to fee account
+        // calculate out (same calculation as `quote`)
+        const trade_record trade = get_trade( ext_in.quantity, pairs, config, amplifier );
+        ext_out = { trade.quantity_out, reserve_out.contract };
         const extended_asset protocol_fee = { ext_in.quantity.amount * config.protocol_fee / 10000, ext_in.get_extended_symbol() };
-        const extended_asset trade_fee = { ext_in.quantity.amount * config.trade_fee / 10000, ext_in.get_extended_symbol() };
-        const extended_asset fee = protocol_fee + trade_fee;
 
         // modify reserves
         _pairs.modify( pairs, get_self(), [&]( auto & row ) {
-            if ( is_in ) {
-                row.reserve0.quantity += ext_in.quantity - protocol_fee.quantity;
-                row.reserve1.quantity -= ext_out.quantity;
-                row.volume0 += ext_in.quantity;
-            } else {
-                row.reserve1.quantity += ext_in.quantity - protocol_fee.quantity;
-                row.reserve0.quantity -= ext_out.quantity;
-                row.volume1 += ext_in.quantity;
-            }
-            // calculate last price
-            const double price = calculate_price( ext_in.quantity, ext_out.quantity );
-            row.amplifier = get_amplifier( pair_id );
-            row.virtual_price = calculate_virtual_price( row.reserve0.quantity, row.reserve1.quantity, row.liquidity.quantity );
-            row.price0_last = is_in ? 1 / price : price;
-            row.price1_last = is_in ? price : 1 / price;
+            upgrade_pair( row );
+            update_oracle( row, amplifier );
+            row.reserve0.quantity = trade.reserve0;
+            row.reserve1.quantity = trade.reserve1;
+            if ( is_in ) row.volume0 += ext_in.quantity;
+            else row.volume1 += ext_in.quantity;
+
+            // calculate last price (both directions from traded quantities)
+            const uint64_t price = trade.trade_price;
+            const uint64_t price_inverse = calculate_price( trade.quantity_out, trade.quantity_in );
+            update_amplifier( row, amplifier );
+            row.set_invariant( get_invariant( row, row.amplifier ), row.amplifier );
+            row.prices.emplace( price_params{ calculate_virtual_price( row ), is_in ? price_inverse : price, is_in ? price : price_inverse } );
             row.trades += 1;
             row.last_updated = current_time_point();
 
-            // swap log
-            curve::swaplog_action swaplog( get_self(), { get_self(), "active"_n });
-            swaplog.send( pair_id, owner, "swap"_n, ext_in.quantity, ext_out.quantity, fee.quantity, price, row.reserve0.quantity, row.reserve1.quantity );
+            // per-hop trade record
+            trades.push_back( trade );
         });
-        // send protocol fees
-        if ( protocol_fee.quantity.amount ) transfer( get_self(), config.fee_account, protocol_fee, "curve.sx: protocol fee");
+        update_observation( pairs, config.observation_interval.value_or( OBSERVATION_INTERVAL ) );
+        // accrue protocol fees (see `claimfees`)
+        if ( protocol_fee.quantity.amount ) accrue_fee( protocol_fee );
 
         // swap input as output to prepare for next conversion
         ext_in = ext_out;
     }
-
     return ext_out;
 }
 
@@ -136,66 +215,47 @@ void curve::deposit( const name owner, const symbol_code pair_id )
 
     curve::config_table _config( get_self(), get_self().value );
     curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::pools_table _pools( get_self(), get_self().value );
     curve::orders_table _orders( get_self(), pair_id.raw() );
 
     // configs
     check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
     auto config = _config.get();
 
+    // N coin pool deposit
+    if ( _pools.find( pair_id.raw() ) != _pools.end() ) return deposit_pool( owner, pair_id );
+
     // get current order & pairs
     auto & pair = _pairs.get( pair_id.raw(), "curve.sx::deposit: `pair_id` does not exist");
     auto & orders = _orders.get( owner.value, "curve.sx::deposit: no deposits available for this user");
     check( orders.quantity0.quantity.amount && orders.quantity1.quantity.amount, "curve.sx::deposit: one of the deposit is empty");
 
-    // symbol helpers
-    const symbol sym0 = pair.reserve0.quantity.symbol;
-    const symbol sym1 = pair.reserve1.quantity.symbol;
-
-    // calculate total deposits based on reserves: reserves ratio should remain the same
-    // if reserves empty, fallback to 1
-    const int128_t reserve0 = pair.reserve0.quantity.amount ? mul_amount(pair.reserve0.quantity.amount, MAX_PRECISION, sym0.precision()) : 1;
-    const int128_t reserve1 = pair.reserve1.quantity.amount ? mul_amount(pair.reserve1.quantity.amount, MAX_PRECISION, sym1.precision()) : 1;
-    const int128_t reserves = reserve0 + reserve1;
-
-    // get owner order and calculate payment
-    const int128_t amount0 = mul_amount(orders.quantity0.quantity.amount, MAX_PRECISION, sym0.precision());
-    const int128_t amount1 = mul_amount(orders.quantity1.quantity.amount, MAX_PRECISION, sym1.precision());
-    const int128_t payment = amount0 + amount1;
-
-    // calculate actual amounts to deposit
-    const int128_t deposit0 = (amount0 * reserves <= reserve0 * payment) ? amount0 : (amount1 * reserve0 / reserve1);
-    const int128_t deposit1 = (amount0 * reserves <= reserve0 * payment) ? (amount0 * reserve1 / reserve0) : amount1;
+    // calculate deposits keeping reserves ratio & issued liquidity (see `get_deposit_out`)
+    const deposit_result result = get_deposit_out( pair, orders.quantity0.quantity, orders.quantity1.quantity );
 
     // send back excess deposit to owner
-    if (deposit0 < amount0) {
-        const int64_t excess_amount = div_amount(static_cast<int64_t>(amount0 - deposit0), MAX_PRECISION, sym0.precision());
-        const extended_asset excess = { excess_amount, pair.reserve0.get_extended_symbol() };
-        if(excess.quantity.amount) transfer( get_self(), owner, excess, "curve.sx: excess");
-    }
-    if (deposit1 < amount1) {
-        const int64_t excess_amount = div_amount(static_cast<int64_t>(amount1 - deposit1), MAX_PRECISION, sym1.precision());
-        const extended_asset excess = { excess_amount, pair.reserve1.get_extended_symbol() };
-        if(excess.quantity.amount) transfer( get_self(), owner, excess, "curve.sx: excess");
-    }
-
-    // normalize final deposits
-    const extended_asset ext_deposit0 = { div_amount(deposit0, MAX_PRECISION, sym0.precision()), pair.reserve0.get_extended_symbol()};
-    const extended_asset ext_deposit1 = { div_amount(deposit1, MAX_PRECISION, sym1.precision()), pair.reserve1.get_extended_symbol()};
+    if ( result.excess0.amount ) transfer( get_self(), owner, { result.excess0, pair.reserve0.contract }, "curve.sx: excess");
+    if ( result.excess1.amount ) transfer( get_self(), owner, { result.excess1, pair.reserve1.contract }, "curve.sx: excess");
 
-    // issue liquidity
-    const int64_t supply = mul_amount(pair.liquidity.quantity.amount, MAX_PRECISION, pair.liquidity.quantity.symbol.precision());
-    const int64_t issued_amount = rex::issue(deposit0 + deposit1, reserves, supply, 1);
-    const extended_asset issued = { div_amount(issued_amount, MAX_PRECISION, pair.liquidity.quantity.symbol.precision()), pair.liquidity.get_extended_symbol()};
+    // final deposits & issued liquidity
+    const extended_asset ext_deposit0 = { result.deposit0, pair.reserve0.contract };
+    const extended_asset ext_deposit1 = { result.deposit1, pair.reserve1.contract };
+    const extended_asset issued = { result.issued, pair.liquidity.contract };
 
     // add liquidity deposits & newly issued liquidity
+    const uint64_t amplifier = get_amplifier( pair );
     _pairs.modify(pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        update_oracle( row, amplifier );
         row.reserve0 += ext_deposit0;
         row.reserve1 += ext_deposit1;
         row.liquidity += issued;
+        update_amplifier( row, amplifier );
+        row.set_invariant( get_invariant( row, amplifier ), amplifier );
 
         // log liquidity change
         curve::liquiditylog_action liquiditylog( get_self(), { get_self(), "active"_n });
-        liquiditylog.send( pair_id, owner, "deposit"_n, issued.quantity, ext_deposit0.quantity, ext_deposit1.quantity, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity );
+        liquiditylog.send( pair_id, owner, "deposit"_n, issued.quantity, ext_deposit0.quantity, ext_deposit1.quantity, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity, config.stats_account.value_or() );
     });
 
     // issue & transfer to owner
@@ -204,6 +264,7 @@ void curve::deposit( const name owner, const symbol_code pair_id )
 
     // delete any remaining liquidity deposit order
     _orders.erase( orders );
+    remove_order_index( owner, pair_id );
 }
 
 // returns any remaining orders to owner account
@@ -212,12 +273,13 @@ void curve::cancel( const name owner, const symbol_code pair_id )
 {
     if ( !has_auth( get_self() )) require_auth( owner );
 
-    curve::orders_table _orders( get_self(), pair_id.raw() );
-    auto & orders = _orders.get( owner.value, "curve.sx::cancel: no deposits for this user in this pool");
-    if ( orders.quantity0.quantity.amount ) transfer( get_self(), owner, orders.quantity0, "curve.sx: cancel");
-    if ( orders.quantity1.quantity.amount ) transfer( get_self(), owner, orders.quantity1, "curve.sx: cancel");
+    // N coin pool order
+    curve::pools_table _pools( get_self(), get_self().value );
+    if ( _pools.find( pair_id.raw() ) != _pools.end() ) return cancel_pool( owner, pair_id );
 
-    _orders.erase( orders );
+    curve::orders_table _orders( get_self(), pair_id.raw() );
+    check( _orders.find( owner.value ) != _orders.end(), "curve.sx::cancel: no deposits for this user in this pool");
+    refund_order( owner, pair_id, "curve.sx: cancel" );
 }
 
 [[eosio::action]]
@@ -228,12 +290,15 @@ void curve::removepair( const symbol_code pair_id )
     curve::pairs_table _pairs( get_self(), get_self().value );
     auto & pair = _pairs.get( pair_id.raw(), "curve.sx::removepair: `pair_id` does not exist");
     check( !pair.liquidity.quantity.amount, "curve.sx::removepair: liquidity must be empty before removing");
+    erase_observations( pair_id );
     _pairs.erase( pair );
 }
 
 void curve::withdraw_liquidity( const name owner, const extended_asset value )
 {
     curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
 
     // get current pairs
     const symbol_code pair_id = value.quantity.symbol.code();
@@ -242,42 +307,25 @@ void curve::withdraw_liquidity( const name owner, const extended_asset value )
     // prevent invalid liquidity token contracts
     check(pair.liquidity.get_extended_symbol() == value.get_extended_symbol(), "curve.sx::withdraw_liquidity: invalid liquidity contract");
 
-    // extended symbols
-    const extended_symbol ext_sym0 = pair.reserve0.get_extended_symbol();
-    const extended_symbol ext_sym1 = pair.reserve1.get_extended_symbol();
-    const symbol sym0 = pair.reserve0.quantity.symbol;
-    const symbol sym1 = pair.reserve1.quantity.symbol;
-
-    // calculate total deposits based on reserves
-    const int64_t supply = mul_amount(pair.liquidity.quantity.amount, MAX_PRECISION, pair.liquidity.quantity.symbol.precision());
-    const int128_t reserve0 = pair.reserve0.quantity.amount ? mul_amount(pair.reserve0.quantity.amount, MAX_PRECISION, sym0.precision()) : 1;
-    const int128_t reserve1 = pair.reserve1.quantity.amount ? mul_amount(pair.reserve1.quantity.amount, MAX_PRECISION, sym1.precision()) : 1;
-    const int128_t reserves = reserve0 + reserve1;
-
-    // calculate withdraw amounts
-    const int64_t payment = mul_amount(value.quantity.amount, MAX_PRECISION, value.quantity.symbol.precision());
-    const int64_t retire_amount = rex::retire( payment, reserves, supply );
-
-    // get owner order and calculate payment
-    int64_t amount0 = static_cast<int64_t>( retire_amount * reserve0 / reserves );
-    int64_t amount1 = static_cast<int64_t>( retire_amount * reserve1 / reserves );
-    if (amount0 == reserve0 || amount1 == reserve1) {         //deal with rounding error on final withdrawal
-        amount0 = static_cast<int64_t>( reserve0 );
-        amount1 = static_cast<int64_t>( reserve1 );
-    }
-    const extended_asset out0 = { div_amount(amount0, MAX_PRECISION, sym0.precision()), ext_sym0 };
-    const extended_asset out1 = { div_amount(amount1, MAX_PRECISION, sym1.precision()), ext_sym1 };
-    check( out0.quantity.amount || out1.quantity.amount, "curve.sx::withdraw_liquidity: withdraw amount too small");
+    // calculate withdraw amounts proportional to reserves (see `get_withdraw_out`)
+    const withdraw_result result = get_withdraw_out( pair, value.quantity );
+    const extended_asset out0 = { result.out0, pair.reserve0.contract };
+    const extended_asset out1 = { result.out1, pair.reserve1.contract };
 
     // add liquidity deposits & newly issued liquidity
+    const uint64_t amplifier = get_amplifier( pair );
     _pairs.modify(pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        update_oracle( row, amplifier );
         row.reserve0 -= out0;
         row.reserve1 -= out1;
         row.liquidity -= value;
+        update_amplifier( row, amplifier );
+        row.set_invariant( get_invariant( row, amplifier ), amplifier );
 
         // log liquidity change
         curve::liquiditylog_action liquiditylog( get_self(), { get_self(), "active"_n });
-        liquiditylog.send( pair_id, owner, "withdraw"_n, value.quantity, -out0.quantity, -out1.quantity, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity );
+        liquiditylog.send( pair_id, owner, "withdraw"_n, value.quantity, -out0.quantity, -out1.quantity, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity, config.stats_account.value_or() );
     });
 
     // issue & transfer to owner
@@ -286,6 +334,50 @@ void curve::withdraw_liquidity( const name owner, const extended_asset value )
     if ( out1.quantity.amount ) transfer( get_self(), owner, out1, "curve.sx: withdraw");
 }
 
+// withdraw liquidity paid out entirely in a single reserve
+// imbalance fee remains in reserves for remaining liquidity providers
+void curve::withdraw_liquidity_one( const name owner, const extended_asset value, const symbol_code symcode_out, const int64_t min_return )
+{
+    curve::config_table _config( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    const auto config = _config.get();
+
+    // get current pairs
+    const symbol_code pair_id = value.quantity.symbol.code();
+    auto & pair = _pairs.get( pair_id.raw(), "curve.sx::withdraw_liquidity_one: `pair_id` does not exist");
+
+    // prevent invalid liquidity token contracts
+    check(pair.liquidity.get_extended_symbol() == value.get_extended_symbol(), "curve.sx::withdraw_liquidity_one: invalid liquidity contract");
+
+    // calculate withdraw amount & enforce minimum return (slippage protection)
+    const uint64_t amplifier = get_amplifier( pair );
+    const bool is_reserve0 = pair.reserve0.quantity.symbol.code() == symcode_out;
+    const extended_symbol ext_sym_out = is_reserve0 ? pair.reserve0.get_extended_symbol() : pair.reserve1.get_extended_symbol();
+    const extended_asset out = { get_withdraw_one_out( value.quantity, pair, symcode_out, config, amplifier ), ext_sym_out.get_contract() };
+    check( out.quantity.amount > 0 && out.quantity.amount >= min_return, "curve.sx::withdraw_liquidity_one: invalid minimum return");
+
+    // remove withdrawn reserve & retired liquidity
+    const asset out0 = is_reserve0 ? out.quantity : asset{ 0, pair.reserve0.quantity.symbol };
+    const asset out1 = is_reserve0 ? asset{ 0, pair.reserve1.quantity.symbol } : out.quantity;
+    _pairs.modify(pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        update_oracle( row, amplifier );
+        row.reserve0.quantity -= out0;
+        row.reserve1.quantity -= out1;
+        row.liquidity -= value;
+        update_amplifier( row, amplifier );
+        row.set_invariant( get_invariant( row, amplifier ), amplifier );
+
+        // log liquidity change
+        curve::liquiditylog_action liquiditylog( get_self(), { get_self(), "active"_n });
+        liquiditylog.send( pair_id, owner, "withdraw"_n, value.quantity, -out0, -out1, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity, config.stats_account.value_or() );
+    });
+
+    // retire & transfer to owner
+    retire( value, "curve.sx: withdraw" );
+    transfer( get_self(), owner, out, "curve.sx: withdraw");
+}
+
 void curve::add_liquidity( const name owner, const symbol_code pair_id, const extended_asset value )
 {
     curve::pairs_table _pairs( get_self(), get_self().value );
@@ -313,8 +405,144 @@ void curve::add_liquidity( const name owner, const symbol_code pair_id, const ex
     };
 
     // create/modify order
-    if ( itr == _orders.end() ) _orders.emplace( get_self(), insert );
-    else _orders.modify( itr, get_self(), insert );
+    if ( itr == _orders.end() ) {
+        _orders.emplace( get_self(), insert );
+        add_order_index( owner, pair_id );
+    } else {
+        _orders.modify( itr, get_self(), insert );
+    }
+}
+
+// deposit any ratio of reserves (including single-sided) in a single transaction
+// issued liquidity is net of imbalance fee, which remains in reserves for liquidity providers
+void curve::add_liquidity_instant( const name owner, const symbol_code pair_id, const extended_asset value, const int64_t min_return )
+{
+    curve::config_table _config( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    const auto config = _config.get();
+    auto & pair = _pairs.get( pair_id.raw(), "curve.sx::add_liquidity_instant: `pair_id` does not exist");
+
+    // validate deposit
+    const extended_symbol ext_sym_in = value.get_extended_symbol();
+    const bool is_reserve0 = ext_sym_in == pair.reserve0.get_extended_symbol();
+    check( is_reserve0 || ext_sym_in == pair.reserve1.get_extended_symbol(), "curve.sx::add_liquidity_instant: invalid extended symbol when adding liquidity");
+    const asset quantity0 = is_reserve0 ? value.quantity : asset{ 0, pair.reserve0.quantity.symbol };
+    const asset quantity1 = is_reserve0 ? asset{ 0, pair.reserve1.quantity.symbol } : value.quantity;
+
+    // calculate issued liquidity & enforce minimum return (slippage protection)
+    const uint64_t amplifier = get_amplifier( pair );
+    const extended_asset issued = { get_imbalanced_deposit_out( pair, quantity0, quantity1, amplifier, config.trade_fee ), pair.liquidity.contract };
+    check( issued.quantity.amount > 0 && issued.quantity.amount >= min_return, "curve.sx::add_liquidity_instant: invalid minimum liquidity");
+
+    // add liquidity deposits & newly issued liquidity
+    _pairs.modify(pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        update_oracle( row, amplifier );
+        if ( is_reserve0 ) row.reserve0 += value;
+        else row.reserve1 += value;
+        row.liquidity += issued;
+        update_amplifier( row, amplifier );
+        row.set_invariant( get_invariant( row, amplifier ), amplifier );
+
+        // log liquidity change
+        curve::liquiditylog_action liquiditylog( get_self(), { get_self(), "active"_n });
+        liquiditylog.send( pair_id, owner, "deposit"_n, issued.quantity, quantity0, quantity1, row.liquidity.quantity, row.reserve0.quantity, row.reserve1.quantity, config.stats_account.value_or() );
+    });
+
+    // issue & transfer to owner
+    issue( issued, "curve.sx: deposit" );
+    transfer( get_self(), owner, issued, "curve.sx: deposit");
+}
+
+// accrue protocol fees in `fees` table, paid out in batch by `claimfees`
+void curve::accrue_fee( const extended_asset fee )
+{
+    curve::fees_table _fees( get_self(), get_self().value );
+    auto _fees_by_token = _fees.get_index<"bytoken"_n>();
+    auto itr = _fees_by_token.find( get_token_key( fee.get_extended_symbol() ) );
+
+    if ( itr == _fees_by_token.end() ) {
+        _fees.emplace( get_self(), [&]( auto & row ) {
+            row.id = _fees.available_primary_key();
+            row.balance = fee;
+        });
+    } else {
+        _fees_by_token.modify( itr, same_payer, [&]( auto & row ) {
+            row.balance += fee;
+        });
+    }
+}
+
+// store current amplifier, completed ramps are collapsed into `amplifier` (see `get_amplifier`)
+void curve::update_amplifier( pairs_row& row, const uint64_t amplifier )
+{
+    row.amplifier = amplifier;
+    if ( !row.ramp.has_value() || !row.ramp.value().target_amplifier ) return;
+    if ( current_time_point().sec_since_epoch() >= row.ramp.value().end_time.sec_since_epoch() ) row.ramp.emplace( ramp_params{} );
+}
+
+// accumulate spot prices of pre-write reserves since last write, priced from cached `invariant` (see `get_price_cumulative`)
+// called after `upgrade_pair` so `oracle` serializes at its position
+void curve::update_oracle( pairs_row& row, const uint64_t amplifier )
+{
+    row.oracle.emplace( get_price_cumulative( row, amplifier, current_time_point() ) );
+}
+
+// populate extensions missing from rows written by previous versions, in declaration order
+// (a `binary_extension` is only serialized if all preceding extensions are present)
+void curve::upgrade_pair( pairs_row& row )
+{
+    if ( !row.invariant.has_value() || !row.invariant_amplifier.has_value() ) row.set_invariant( 0, 0 );
+    if ( !row.ramp.has_value() ) {
+        // fold legacy `ramp` table row (see `get_ramp`)
+        curve::ramp_table _ramp( get_self(), get_self().value );
+        auto itr = _ramp.find( row.id.raw() );
+        if ( itr == _ramp.end() ) row.ramp.emplace( ramp_params{} );
+        else {
+            row.ramp.emplace( ramp_params{ itr->start_amplifier, itr->target_amplifier, itr->start_time, itr->end_time } );
+            _ramp.erase( itr );
+        }
+    }
+    if ( !row.scales.has_value() ) row.scales.emplace( scale_params{ static_cast<uint64_t>(row.get_scale0()), static_cast<uint64_t>(row.get_scale1()), static_cast<uint64_t>(row.get_scale_lp()) } );
+    if ( !row.oracle.has_value() ) row.oracle.emplace( oracle_params{ 0, 0, current_time_point() } );
+    if ( !row.prices.has_value() ) row.prices.emplace( row.get_prices() );
+}
+
+// populate config extensions missing after upgrade (log actions notify `stats_account` only once it is set)
+void curve::upgrade_config( config_row& config )
+{
+    if ( !config.stats_account.has_value() ) config.stats_account.emplace( is_account( "stats.sx"_n ) ? "stats.sx"_n : name{} );
+}
+
+// pays out accrued protocol fees to `config.fee_account`, at most `max_rows` tokens per call (permissionless)
+// optional `token` claims a single token, so a token rejecting transfers does not block the others
+[[eosio::action]]
+void curve::claimfees( const uint64_t max_rows, const optional<extended_symbol> token )
+{
+    curve::config_table _config( get_self(), get_self().value );
+    curve::fees_table _fees( get_self(), get_self().value );
+    check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+    check( max_rows > 0, "curve.sx::claimfees: `max_rows` must be positive");
+    const name fee_account = _config.get().fee_account;
+    check( fee_account.value, "curve.sx::claimfees: `fee_account` is not defined");
+
+    // paid out rows are erased (re-emplaced by `accrue_fee`)
+    uint64_t count = 0;
+    if ( token ) {
+        auto _fees_by_token = _fees.get_index<"bytoken"_n>();
+        auto itr = _fees_by_token.find( get_token_key( *token ) );
+        if ( itr != _fees_by_token.end() ) {
+            if ( itr->balance.quantity.amount ) transfer( get_self(), fee_account, itr->balance, "curve.sx: protocol fee");
+            _fees_by_token.erase( itr );
+            ++count;
+        }
+    } else {
+        for ( auto itr = _fees.begin(); itr != _fees.end() && count < max_rows; ++count ) {
+            if ( itr->balance.quantity.amount ) transfer( get_self(), fee_account, itr->balance, "curve.sx: protocol fee");
+            itr = _fees.erase( itr );
+        }
+    }
+    check( count, "curve.sx::claimfees: no protocol fees to claim");
 }
 
 // increase/decrease amplifier of given pair id
@@ -323,26 +551,18 @@ void curve::ramp( const symbol_code pair_id, const uint64_t target_amplifier, co
 {
     require_auth( get_self() );
 
-    curve::ramp_table _ramp_table( get_self(), get_self().value );
     curve::pairs_table _pairs( get_self(), get_self().value );
-    auto pair = _pairs.get(pair_id.raw(), "curve.sx::ramp: `pair_id` does not exist in `pairs`");
+    auto & pair = _pairs.get(pair_id.raw(), "curve.sx::ramp: `pair_id` does not exist in `pairs`");
 
     // validation
     check( target_amplifier > 0 && target_amplifier <= MAX_AMPLIFIER, "curve.sx::ramp: target amplifier should be within within valid range");
     check( minutes > 0, "curve.sx::ramp: minutes should be above 0");
     check( minutes * 60 >= MIN_RAMP_TIME, "curve.sx::ramp: minimum ramp timeframe must exceed " + to_string(MIN_RAMP_TIME) + " seconds");
 
-    auto insert = [&]( auto & row ) {
-        row.pair_id = pair_id;
-        row.start_amplifier = pair.amplifier;
-        row.target_amplifier = target_amplifier;
-        row.start_time = current_time_point();
-        row.end_time = current_time_point() + eosio::minutes(minutes);
-    };
-
-    auto itr = _ramp_table.find(pair_id.raw());
-    if ( itr == _ramp_table.end() ) _ramp_table.emplace( get_self(), insert );
-    else _ramp_table.modify( itr, get_self(), insert );
+    _pairs.modify( pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        row.ramp.emplace( ramp_params{ pair.amplifier, target_amplifier, current_time_point(), current_time_point() + eosio::minutes(minutes) } );
+    });
 }
 
 [[eosio::action]]
@@ -350,9 +570,14 @@ void curve::stopramp( const symbol_code pair_id )
 {
     require_auth( get_self() );
 
-    curve::ramp_table _ramp( get_self(), get_self().value );
-    auto & ramp = _ramp.get(pair_id.raw(), "curve.sx::stopramp: `pair_id` does not exist in `ramp` table");
-    _ramp.erase( ramp );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    auto & pair = _pairs.get(pair_id.raw(), "curve.sx::stopramp: `pair_id` does not exist in `pairs`");
+    check( get_ramp( pair ).target_amplifier, "curve.sx::stopramp: `pair_id` does not exist in ramping pairs");
+
+    _pairs.modify( pair, get_self(), [&]( auto & row ) {
+        upgrade_pair( row );
+        row.ramp.emplace( ramp_params{} );
+    });
 }
 
 [[eosio::action]]
@@ -373,6 +598,7 @@ void curve::setfee( const uint8_t trade_fee, const optional<uint8_t> protocol_fe
     if ( *protocol_fee ) check( fee_account->value, "curve.sx::setfee: must provide `fee_account` if `protocol_fee` is defined");
 
     // set config
+    upgrade_config( config );
     config.trade_fee = trade_fee;
     config.protocol_fee = *protocol_fee;
     config.fee_account = *fee_account;
@@ -387,9 +613,53 @@ void curve::setstatus( const name status )
     curve::config_table _config( get_self(), get_self().value );
     auto config = _config.get_or_default();
     config.status = status;
+    config.stats_account.emplace( is_account( "stats.sx"_n ) ? "stats.sx"_n : name{} );
     _config.set( config, get_self() );
 }
 
+// upgrade rows written by previous versions, at most `max_rows` per call (see `upgrade_pair` & `upgrade_config`)
+// fixed-point `prices` are converted from the legacy `double` fields, which are left untouched
+[[eosio::action]]
+void curve::migrate( const uint64_t max_rows )
+{
+    require_auth( get_self() );
+
+    // config extensions (see `upgrade_config`)
+    curve::config_table _config( get_self(), get_self().value );
+    auto config = _config.get();
+    const bool upgraded = !config.stats_account.has_value();
+    upgrade_config( config );
+    if ( upgraded ) _config.set( config, get_self() );
+
+    // `prices` is the last extension, rows having it are fully upgraded
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    vector<pairs_row> rows;
+    for ( auto itr = _pairs.begin(); itr != _pairs.end() && rows.size() < max_rows; ++itr ) {
+        if ( !itr->prices.has_value() ) rows.push_back( *itr );
+    }
+
+    // legacy rows predate the secondary indices (`modify` does not create them), erase & re-emplace to index them
+    // pairs are created by the contract itself during beta period, which remains the RAM payer
+    for ( auto row : rows ) {
+        upgrade_pair( row );
+        _pairs.erase( _pairs.get( row.id.raw(), "curve.sx::migrate: `pair_id` does not exist" ) );
+        _pairs.emplace( get_self(), [&]( auto & r ) {
+            r = row;
+        });
+    }
+    uint64_t count = rows.size();
+
+    // legacy `ramp` rows are folded into `pairs.ramp` by `upgrade_pair`, drop rows of removed pairs
+    curve::ramp_table _ramp( get_self(), get_self().value );
+    for ( auto itr = _ramp.begin(); itr != _ramp.end() && count < max_rows; ) {
+        const auto pair = _pairs.find( itr->pair_id.raw() );
+        if ( pair != _pairs.end() && !pair->ramp.has_value() ) { ++itr; continue; }
+        itr = _ramp.erase( itr );
+        ++count;
+    }
+    check( count || upgraded, "curve.sx::migrate: no pairs to migrate");
+}
+
 [[eosio::action]]
 void curve::createpair( const name creator, const symbol_code pair_id, const extended_symbol reserve0, const extended_symbol reserve1, const uint64_t amplifier )
 {
@@ -399,6 +669,7 @@ void curve::createpair( const name creator, const symbol_code pair_id, const ext
 
     // tables
     curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::pools_table _pools( get_self(), get_self().value );
     curve::config_table _config( get_self(), get_self().value );
 
     // reserve params
@@ -413,6 +684,10 @@ void curve::createpair( const name creator, const symbol_code pair_id, const ext
     check( token::get_supply( contract0, sym0.code() ).symbol == sym0, "curve.sx::createpair: reserve0 symbol mismatch" );
     check( token::get_supply( contract1, sym1.code() ).symbol == sym1, "curve.sx::createpair: reserve1 symbol mismatch" );
     check( _pairs.find( pair_id.raw() ) == _pairs.end(), "curve.sx::createpair: `pair_id` already exists" );
+    check( _pools.find( pair_id.raw() ) == _pools.end(), "curve.sx::createpair: `pair_id` already exists in `pools`" );
+    check( reserve0 != reserve1, "curve.sx::createpair: reserves must be different" );
+    auto _pairs_by_tokens = _pairs.get_index<"bytokens"_n>();
+    check( _pairs_by_tokens.find( get_pair_key( reserve0, reserve1 ) ) == _pairs_by_tokens.end(), "curve.sx::createpair: reserves pair already exists" );
     check( amplifier > 0 && amplifier <= MAX_AMPLIFIER, "curve.sx::createpair: invalid amplifier" );
     check( sym0.precision() <= MAX_PRECISION && sym1.precision() <= MAX_PRECISION, "curve.sx::createpair: only tokens with precision <= `MAX_PRECISION` allowed" );
 
@@ -438,56 +713,142 @@ void curve::createpair( const name creator, const symbol_code pair_id, const ext
         row.volume0 = { 0, sym0 };
         row.volume1 = { 0, sym1 };
         row.last_updated = current_time_point();
+        row.set_invariant( 0, amplifier );
+        row.ramp.emplace( ramp_params{} );
+        row.scales.emplace( scale_params{ static_cast<uint64_t>(get_scale( sym0.precision() )), static_cast<uint64_t>(get_scale( sym1.precision() )), static_cast<uint64_t>(get_scale( liquidity.get_symbol().precision() )) } );
+        row.oracle.emplace( oracle_params{ 0, 0, current_time_point() } );
+        row.prices.emplace( price_params{ 0, 0, 0 } );
     });
+
+    // drop legacy ramp of a removed pair (see `get_ramp`)
+    curve::ramp_table _ramp( get_self(), get_self().value );
+    auto ramp = _ramp.find( pair_id.raw() );
+    if ( ramp != _ramp.end() ) _ramp.erase( ramp );
 }
 
-// calculate reserve amounts relative to supply
-double curve::calculate_virtual_price( const asset value0, const asset value1, const asset supply )
+// calculate reserve amounts relative to supply (scaled by `Curve::PRICE_SCALE`)
+uint64_t curve::calculate_virtual_price( const pairs_row& pair )
 {
-    const int64_t amount0 = mul_amount( value0.amount, MAX_PRECISION, value0.symbol.precision() );
-    const int64_t amount1 = mul_amount( value1.amount, MAX_PRECISION, value1.symbol.precision() );
-    const int64_t amount2 = mul_amount( supply.amount, MAX_PRECISION, supply.symbol.precision() );
-    return static_cast<double>( safemath::add(amount0, amount1) ) / amount2;
+    const int64_t supply = pair.get_supply();
+    if ( !supply ) return 0;
+    const uint128_t price = static_cast<uint128_t>( safemath::add(pair.get_reserve0(), pair.get_reserve1()) ) * Curve::PRICE_SCALE / supply;
+    return price > UINT64_MAX ? UINT64_MAX : static_cast<uint64_t>( price );
 }
 
-// calculate last price per trade
-double curve::calculate_price( const asset value0, const asset value1 )
+// calculate last price per trade (scaled by `Curve::PRICE_SCALE`, saturated for dust quantities)
+uint64_t curve::calculate_price( const asset value0, const asset value1 )
 {
     const int64_t amount0 = mul_amount( value0.amount, MAX_PRECISION, value0.symbol.precision() );
     const int64_t amount1 = mul_amount( value1.amount, MAX_PRECISION, value1.symbol.precision() );
-    return static_cast<double>(amount0) / amount1;
+    if ( !amount1 ) return 0;
+    const uint128_t price = static_cast<uint128_t>( amount0 ) * Curve::PRICE_SCALE / amount1;
+    return price > UINT64_MAX ? UINT64_MAX : static_cast<uint64_t>( price );
 }
 
 // Memo schemas
 // ============
 // Swap: `swap,<min_return>,<pair_ids>` (ex: "swap,0,SXA" )
-// Deposit: `deposit,<pair_id>` (ex: "deposit,SXA")
+// Swap auto route: `swap,<min_return>,auto,<symcode_out>` (ex: "swap,0,auto,USN" )
+// Swap split routes: `swap,<min_return>,<pair_ids>:<weight>|<pair_ids>:<weight>` (ex: "swap,0,SXA:60|SXB-SXC:40" or optimized "swap,0,SXA|SXB-SXC" )
+// Swap exact output: `swapout,<max_in>,<amount_out>,<pair_ids>` (ex: "swapout,100000,99000,SXA" )
+// Swap via N coin pool: `swappool,<min_return>,<pool_id>,<symcode_out>` (ex: "swappool,0,ABC,C" )
+// Deposit: `deposit,<pair_id>` or `deposit,<pool_id>` (ex: "deposit,SXA")
+// Deposit single transaction: `deposit,<pair_id>,<min_return>` (ex: "deposit,SXA,0")
 // Withdrawal: `` (empty)
-curve::memo_schema curve::parse_memo( const string memo )
+// Withdrawal single reserve: `withdrawone,<symbol>,<min_return>` (ex: "withdrawone,USDT,0")
+curve::memo_schema curve::parse_memo( const string& memo )
 {
     if(memo == "") return {};
 
-    // split memo into parts
-    const vector<string> parts = sx::utils::split(memo, ",");
-    check(parts.size() <= 3, ERROR_INVALID_MEMO );
+    // split memo into parts (views into `memo`, no heap allocation)
+    std::array<string_view, 4> parts;
+    const size_t size = sx::utils::split_view( memo, ',', parts );
+    check( size <= 4, ERROR_INVALID_MEMO );
 
     // memo result
     memo_schema result;
     result.action = sx::utils::parse_name(parts[0]);
     result.min_return = 0;
+    result.max_in = 0;
+    result.instant = false;
 
     // swap action
     if ( result.action == "swap"_n ) {
-        result.pair_ids = parse_memo_pair_ids( parts[2] );
-        check( sx::utils::is_digit( parts[1] ), ERROR_INVALID_MEMO );
-        result.min_return = std::stoll( parts[1] );
+        check( size == 3 || size == 4, ERROR_INVALID_MEMO );
+        result.min_return = sx::utils::parse_amount( parts[1] );
         check( result.min_return >= 0, ERROR_INVALID_MEMO );
+
+        // auto route (pair ids resolved by `find_route`)
+        if ( parts[2] == "auto" ) {
+            check( size == 4, ERROR_INVALID_MEMO );
+            result.symcode_out = sx::utils::parse_symbol_code( parts[3] );
+            check( result.symcode_out.raw(), ERROR_INVALID_MEMO );
+
+        // split routes (weights in percent, optimized by `get_split_amounts` when omitted)
+        } else if ( parts[2].find('|') != string_view::npos ) {
+            check( size == 3, ERROR_INVALID_MEMO );
+            std::array<string_view, MAX_SPLIT_LEGS> legs;
+            const size_t legs_size = sx::utils::split_view( parts[2], '|', legs );
+            check( legs_size >= 2 && legs_size <= MAX_SPLIT_LEGS, ERROR_INVALID_MEMO );
+            for ( size_t i = 0; i < legs_size; ++i ) {
+                std::array<string_view, 2> leg_parts;
+                const size_t leg_size = sx::utils::split_view( legs[i], ':', leg_parts );
+                check( leg_size == 1 || leg_size == 2, ERROR_INVALID_MEMO );
+                result.legs.push_back( parse_memo_pair_ids( leg_parts[0] ) );
+                if ( leg_size == 2 ) {
+                    const int64_t weight = sx::utils::parse_amount( leg_parts[1] );
+                    check( weight >= 0, ERROR_INVALID_MEMO );
+                    result.weights.push_back( weight );
+                }
+            }
+            check( result.weights.empty() || result.weights.size() == result.legs.size(), ERROR_INVALID_MEMO );
+        } else {
+            check( size == 3, ERROR_INVALID_MEMO );
+            result.pair_ids = parse_memo_pair_ids( parts[2] );
+            check( result.pair_ids.size() >= 1, ERROR_INVALID_MEMO );
+        }
+
+    // swap exact output action
+    } else if ( result.action == "swapout"_n ) {
+        check( size == 4, ERROR_INVALID_MEMO );
+        result.pair_ids = parse_memo_pair_ids( parts[3] );
+        result.max_in = sx::utils::parse_amount( parts[1] );
+        result.min_return = sx::utils::parse_amount( parts[2] );
+        check( result.max_in > 0 && result.min_return > 0, ERROR_INVALID_MEMO );
         check( result.pair_ids.size() >= 1, ERROR_INVALID_MEMO );
 
+    // swap via N coin pool action
+    } else if ( result.action == "swappool"_n ) {
+        check( size == 4, ERROR_INVALID_MEMO );
+        result.min_return = sx::utils::parse_amount( parts[1] );
+        check( result.min_return >= 0, ERROR_INVALID_MEMO );
+        const symbol_code pool_id = sx::utils::parse_symbol_code( parts[2] );
+        result.symcode_out = sx::utils::parse_symbol_code( parts[3] );
+        check( pool_id.raw() && result.symcode_out.raw(), ERROR_INVALID_MEMO );
+        result.pair_ids = { pool_id };
+
+    // withdraw into a single reserve action
+    } else if ( result.action == "withdrawone"_n ) {
+        check( size == 3, ERROR_INVALID_MEMO );
+        result.symcode_out = sx::utils::parse_symbol_code( parts[1] );
+        check( result.symcode_out.raw(), ERROR_INVALID_MEMO );
+        result.min_return = sx::utils::parse_amount( parts[2] );
+        check( result.min_return >= 0, ERROR_INVALID_MEMO );
+
     // deposit action
     } else if ( result.action == "deposit"_n ) {
+        check( size == 2 || size == 3, ERROR_INVALID_MEMO );
         result.pair_ids = parse_memo_pair_ids( parts[1] );
         check( result.pair_ids.size() == 1, ERROR_INVALID_MEMO );
+        if ( size == 3 ) {
+            result.min_return = sx::utils::parse_amount( parts[2] );
+            check( result.min_return >= 0, ERROR_INVALID_MEMO );
+            result.instant = true;
+        }
+
+    // batch balance action
+    } else if ( result.action == "batch"_n ) {
+        check( size == 1, ERROR_INVALID_MEMO );
     }
     return result;
 }
@@ -496,19 +857,20 @@ curve::memo_schema curve::parse_memo( const string memo )
 // ============
 // Single: `<pair_id>` (ex: "SXA")
 // Multiple: `<pair_id>-<pair_id>` (ex: "SXA-SXB")
-vector<symbol_code> curve::parse_memo_pair_ids( const string memo )
+// `pair_id` existence is validated when the pair/pool row is loaded (ex: `apply_trade`)
+vector<symbol_code> curve::parse_memo_pair_ids( const string_view memo )
 {
-    curve::pairs_table _pairs( get_self(), get_self().value );
-
-    set<symbol_code> duplicates;
     vector<symbol_code> pair_ids;
-    for ( const string str : sx::utils::split(memo, "-") ) {
-        const symbol_code symcode = sx::utils::parse_symbol_code( str );
+    pair_ids.reserve( std::count( memo.begin(), memo.end(), '-' ) + 1 );
+    size_t pos = 0;
+    string_view token;
+    while ( sx::utils::next_token( memo, '-', pos, token ) ) {
+        const symbol_code symcode = sx::utils::parse_symbol_code( token );
         check( symcode.raw(), ERROR_INVALID_MEMO );
-        check( _pairs.find( symcode.raw() ) != _pairs.end(), "curve.sx::parse_memo_pair_ids: `pair_id` does not exist");
+
+        // routes are short, linear scan instead of `set`
+        check( std::find( pair_ids.begin(), pair_ids.end(), symcode ) == pair_ids.end(), "curve.sx::parse_memo_pair_ids: invalid duplicate `pair_ids`");
         pair_ids.push_back( symcode );
-        check( !duplicates.count( symcode ), "curve.sx::parse_memo_pair_ids: invalid duplicate `pair_ids`");
-        duplicates.insert( symcode );
     }
     return pair_ids;
 }
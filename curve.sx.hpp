@@ -4,9 +4,11 @@
 #include <eosio/time.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/crypto.hpp>
 
 #include "curve.hpp"
 
+#include <array>
 #include <optional>
 
 using namespace eosio;
@@ -15,15 +17,26 @@ using namespace std;
 // Static values
 static constexpr name TOKEN_CONTRACT = "lptoken.sx"_n;
 static constexpr uint8_t MAX_PRECISION = 9;
+static constexpr std::array<int64_t, MAX_PRECISION + 1> POW10 = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
 static constexpr int64_t asset_mask{(1LL << 62) - 1};
 static constexpr int64_t asset_max{ asset_mask }; //  4611686018427387903
 static constexpr uint32_t MIN_RAMP_TIME = 86400;
 static constexpr uint32_t MAX_AMPLIFIER = 1000000;
 static constexpr uint32_t MAX_PROTOCOL_FEE = 100;
 static constexpr uint32_t MAX_TRADE_FEE = 50;
+static constexpr uint8_t MIN_POOL_COINS = 3;
+static constexpr uint8_t MAX_POOL_COINS = 4;
+static constexpr uint8_t MAX_ROUTE_HOPS = 3;
+static constexpr uint8_t MAX_ROUTE_QUOTES = 32;
+static constexpr uint8_t MAX_SPLIT_LEGS = 4;
+static constexpr uint8_t SPLIT_STEPS = 20;
+static constexpr uint8_t OBSERVATION_SLOTS = 48;
+static constexpr uint32_t OBSERVATION_INTERVAL = 3600;
+static constexpr uint32_t MIN_OBSERVATION_INTERVAL = 60;
+static constexpr uint32_t ORDER_EXPIRE_TIME = 86400;
 
 // Error messages
-static string ERROR_INVALID_MEMO = "curve.sx: invalid memo (ex: \"swap,<min_return>,<pair_ids>\" or \"deposit,<pair_id>\"";
+static string ERROR_INVALID_MEMO = "curve.sx: invalid memo (ex: \"swap,<min_return>,<pair_ids>\", \"swap,<min_return>,auto,<symcode_out>\", \"swap,<min_return>,<pair_ids>:<weight>|<pair_ids>:<weight>\", \"swapout,<max_in>,<amount_out>,<pair_ids>\", \"swappool,<min_return>,<pool_id>,<symcode_out>\", \"deposit,<pair_id>\", \"deposit,<pair_id>,<min_return>\", \"withdrawone,<symbol>,<min_return>\" or \"batch\"";
 static string ERROR_CONFIG_NOT_EXISTS = "curve.sx: contract is under maintenance";
 
 namespace sx {
@@ -42,7 +55,9 @@ public:
      * - `{name} status` - contract status ("ok", "testing", "maintenance")
      * - `{uint8_t} trade_fee` - trading fee (pips 1/100 of 1%)
      * - `{uint8_t} protocol_fee` - trading fee (pips 1/100 of 1%)
-     * - `{name} fee_account` - protocol fee are transfered to account
+     * - `{name} fee_account` - protocol fees are paid out to account (see `claimfees`)
+     * - `{binary_extension<name>} stats_account` - notified by log actions if exists (refreshed by `setstatus`, initialized by any config update after upgrade)
+     * - `{binary_extension<uint32_t>} observation_interval` - seconds between `observations` (see `setinterval`, default `OBSERVATION_INTERVAL`)
      *
      * ### example
      *
@@ -51,7 +66,9 @@ public:
      *   "status": "ok",
      *   "trade_fee": 4,
      *   "protocol_fee": 0,
-     *   "fee_account": "fee.sx"
+     *   "fee_account": "fee.sx",
+     *   "stats_account": "stats.sx",
+     *   "observation_interval": 3600
      * }
      * ```
      */
@@ -60,6 +77,8 @@ public:
         uint8_t             trade_fee = 4;
         uint8_t             protocol_fee = 0;
         name                fee_account = "fee.sx"_n;
+        binary_extension<name> stats_account;
+        binary_extension<uint32_t> observation_interval;
     };
     typedef eosio::singleton< "config"_n, config_row > config_table;
 
@@ -91,6 +110,179 @@ public:
     };
     typedef eosio::multi_index< "orders"_n, orders_row> orders_table;
 
+    /**
+     * ## TABLE `orderindex`
+     *
+     * Index of pending `orders` across pairs (maintained with `orders` rows), used by `cancelall` & `expireorders`
+     *
+     * - `{uint64_t} id` - primary key
+     * - `{name} owner` - owner account
+     * - `{symbol_code} pair_id` - pair id (scope of `orders` row)
+     * - `{time_point_sec} created_at` - order creation time (first deposit)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "id": 0,
+     *   "owner": "myaccount",
+     *   "pair_id": "AB",
+     *   "created_at": "2021-02-03T00:00:00"
+     * }
+     * ```
+     */
+    struct [[eosio::table("orderindex")]] orderindex_row {
+        uint64_t            id;
+        name                owner;
+        symbol_code         pair_id;
+        time_point_sec      created_at;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_owner() const { return static_cast<uint128_t>( owner.value ) << 64 | pair_id.raw(); }
+        uint64_t by_created() const { return created_at.sec_since_epoch(); }
+    };
+    typedef eosio::multi_index< "orderindex"_n, orderindex_row,
+        indexed_by< "byowner"_n, const_mem_fun<orderindex_row, uint128_t, &orderindex_row::by_owner> >,
+        indexed_by< "bycreated"_n, const_mem_fun<orderindex_row, uint64_t, &orderindex_row::by_created> >
+    > orderindex_table;
+
+    /**
+     * ## STRUCT `ramp_params`
+     *
+     * Amplifier ramp of a pair (stored inline in `pairs`, cleared when `target_amplifier` is 0)
+     *
+     * - `{uint64_t} start_amplifier` - start amplifier when `ramp` action is initialized
+     * - `{uint64_t} target_amplifier` - target amplifier when end time is reached
+     * - `{time_point_sec} start_time` - start time when `ramp` action is initialized
+     * - `{time_point_sec} end_time` - end time when target amplifier will be reached
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "start_amplifier": 100,
+     *   "target_amplifier": 200,
+     *   "start_time": "2021-02-03T00:00:00",
+     *   "end_time": "2021-02-04T00:00:00"
+     * }
+     * ```
+     */
+    struct ramp_params {
+        uint64_t            start_amplifier;
+        uint64_t            target_amplifier;
+        time_point_sec      start_time;
+        time_point_sec      end_time;
+    };
+
+    /**
+     * ## TABLE `ramp`
+     *
+     * Legacy ramps of pairs written before `pairs.ramp`, read by `get_ramp` until folded into `pairs.ramp` (see `migrate`)
+     *
+     * - `{symbol_code} pair_id` - pair id
+     * - `{uint64_t} start_amplifier` - start amplifier when `ramp` action is initialized
+     * - `{uint64_t} target_amplifier` - target amplifier when end time is reached
+     * - `{time_point_sec} start_time` - start time when `ramp` action is initialized
+     * - `{time_point_sec} end_time` - end time when target amplifier will be reached
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "pair_id": "AB",
+     *   "start_amplifier": 100,
+     *   "target_amplifier": 200,
+     *   "start_time": "2021-02-03T00:00:00",
+     *   "end_time": "2021-02-04T00:00:00"
+     * }
+     * ```
+     */
+    struct [[eosio::table("ramp")]] ramp_row {
+        symbol_code         pair_id;
+        uint64_t            start_amplifier;
+        uint64_t            target_amplifier;
+        time_point_sec      start_time;
+        time_point_sec      end_time;
+
+        uint64_t primary_key() const { return pair_id.raw(); }
+    };
+    typedef eosio::multi_index< "ramp"_n, ramp_row> ramp_table;
+
+    /**
+     * ## STRUCT `scale_params`
+     *
+     * Scale factors normalizing pair quantities to `MAX_PRECISION` (stored inline in `pairs` by `createpair`)
+     *
+     * - `{uint64_t} scale0` - reserve0 scale factor
+     * - `{uint64_t} scale1` - reserve1 scale factor
+     * - `{uint64_t} scale_lp` - liquidity scale factor
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "scale0": 100000,
+     *   "scale1": 1,
+     *   "scale_lp": 100000
+     * }
+     * ```
+     */
+    struct scale_params {
+        uint64_t            scale0;
+        uint64_t            scale1;
+        uint64_t            scale_lp;
+    };
+
+    /**
+     * ## STRUCT `oracle_params`
+     *
+     * Cumulative spot prices of a pair (stored inline in `pairs`, see `get_price_cumulative` & `get_twap`)
+     *
+     * - `{uint128_t} price0_cumulative` - sum of reserve0 spot price (scaled by `Curve::PRICE_SCALE`) x seconds elapsed
+     * - `{uint128_t} price1_cumulative` - sum of reserve1 spot price (scaled by `Curve::PRICE_SCALE`) x seconds elapsed
+     * - `{time_point_sec} timestamp` - last accumulated timestamp
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "price0_cumulative": "86400000000000",
+     *   "price1_cumulative": "86400000000000",
+     *   "timestamp": "2021-02-04T00:00:00"
+     * }
+     * ```
+     */
+    struct oracle_params {
+        uint128_t           price0_cumulative;
+        uint128_t           price1_cumulative;
+        time_point_sec      timestamp;
+    };
+
+    /**
+     * ## STRUCT `price_params`
+     *
+     * Virtual price & last trade prices of a pair as fixed point (stored inline in `pairs`, see `get_prices`)
+     *
+     * - `{uint64_t} virtual_price` - reserves relative to liquidity supply (scaled by `Curve::PRICE_SCALE`)
+     * - `{uint64_t} price0_last` - last price for reserve0 (scaled by `Curve::PRICE_SCALE`)
+     * - `{uint64_t} price1_last` - last price for reserve1 (scaled by `Curve::PRICE_SCALE`)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "virtual_price": 1000000000,
+     *   "price0_last": 1000000000,
+     *   "price1_last": 1000000000
+     * }
+     * ```
+     */
+    struct price_params {
+        uint64_t            virtual_price;
+        uint64_t            price0_last;
+        uint64_t            price1_last;
+    };
+
     /**
      * ## TABLE `pairs`
      *
@@ -99,12 +291,19 @@ public:
      * - `{extended_asset} reserve1` - reserve1 asset
      * - `{extended_asset} liquidity` - liquidity asset
      * - `{uint64_t} amplifier` - amplifier
-     * - `{double} price0_last` - last price for reserve0
-     * - `{double} price1_last` - last price for reserve1
+     * - `{double} virtual_price` - legacy reserves relative to liquidity supply (no longer updated, see `prices`)
+     * - `{double} price0_last` - legacy last price for reserve0 (no longer updated, see `prices`)
+     * - `{double} price1_last` - legacy last price for reserve1 (no longer updated, see `prices`)
      * - `{asset} volume0` - cumulative incoming trading volume for reserve0
      * - `{asset} volume1` - cumulative incoming trading volume for reserve1
      * - `{uint64_t} trades` - cumulative trades count
      * - `{time_point_sec} last_updated` - last updated timestamp
+     * - `{binary_extension<uint64_t>} invariant` - StableSwap invariant D of reserves (normalized to `MAX_PRECISION`, see `get_invariant_hint`)
+     * - `{binary_extension<uint64_t>} invariant_amplifier` - amplifier used to calculate `invariant`
+     * - `{ramp_params} ramp` - amplifier ramp in progress (see `ramp`)
+     * - `{scale_params} scales` - scale factors to `MAX_PRECISION` (see `get_reserve0`, `get_reserve1` & `get_supply`)
+     * - `{oracle_params} oracle` - cumulative spot prices (see `get_twap`)
+     * - `{price_params} prices` - fixed-point virtual & last trade prices (converted from legacy fields on next write or `migrate`, see `get_prices`)
      *
      * ### example
      *
@@ -121,7 +320,13 @@ public:
      *   "volume0": "100.0000 A",
      *   "volume1": "100.0000 B",
      *   "trades": 123,
-     *   "last_updated": "2020-11-23T00:00:00"
+     *   "last_updated": "2020-11-23T00:00:00",
+     *   "invariant": 2000000000000,
+     *   "invariant_amplifier": 450,
+     *   "ramp": {"start_amplifier": 0, "target_amplifier": 0, "start_time": "1970-01-01T00:00:00", "end_time": "1970-01-01T00:00:00"},
+     *   "scales": {"scale0": 100000, "scale1": 100000, "scale_lp": 100000},
+     *   "oracle": {"price0_cumulative": "86400000000000", "price1_cumulative": "86400000000000", "timestamp": "2020-11-23T00:00:00"},
+     *   "prices": {"virtual_price": 1000200000, "price0_last": 1000100000, "price1_last": 999900010}
      * }
      * ```
      */
@@ -138,174 +343,1573 @@ public:
         asset               volume1;
         uint64_t            trades;
         time_point_sec      last_updated;
+        binary_extension<uint64_t> invariant;
+        binary_extension<uint64_t> invariant_amplifier;
+        binary_extension<ramp_params> ramp;
+        binary_extension<scale_params> scales;
+        binary_extension<oracle_params> oracle;
+        binary_extension<price_params> prices;
+
+        // cached invariant if computed with {amp}, 0 (cold start) otherwise & for rows created before `invariant`
+        uint64_t get_invariant_hint( const uint64_t amp ) const { return invariant.has_value() && invariant_amplifier.has_value() && invariant_amplifier.value() == amp ? invariant.value() : 0; }
+        void set_invariant( const uint64_t D, const uint64_t amp ) { invariant.emplace( D ); invariant_amplifier.emplace( amp ); }
+
+        // fixed-point prices (converted from legacy fields for rows created before `prices`)
+        price_params get_prices() const { return prices.has_value() ? prices.value() : price_params{ to_fixed_price( virtual_price ), to_fixed_price( price0_last ), to_fixed_price( price1_last ) }; }
+
+        // scale factors (computed from precisions for rows created before `scales`)
+        int64_t get_scale0() const { return scales.has_value() ? scales.value().scale0 : get_scale( reserve0.quantity.symbol.precision() ); }
+        int64_t get_scale1() const { return scales.has_value() ? scales.value().scale1 : get_scale( reserve1.quantity.symbol.precision() ); }
+        int64_t get_scale_lp() const { return scales.has_value() ? scales.value().scale_lp : get_scale( liquidity.quantity.symbol.precision() ); }
+
+        // quantities normalized to `MAX_PRECISION`
+        int64_t get_reserve0() const { return mul_scale( reserve0.quantity.amount, get_scale0() ); }
+        int64_t get_reserve1() const { return mul_scale( reserve1.quantity.amount, get_scale1() ); }
+        int64_t get_supply() const { return mul_scale( liquidity.quantity.amount, get_scale_lp() ); }
+
+        // swap reserve0 & reserve1 (with their scale factors)
+        void inverse_reserves() {
+            std::swap( reserve0, reserve1 );
+            if ( scales.has_value() ) scales.emplace( scale_params{ scales.value().scale1, scales.value().scale0, scales.value().scale_lp } );
+        }
 
         uint64_t primary_key() const { return id.raw(); }
+        uint128_t by_reserve0() const { return get_token_key( reserve0.get_extended_symbol() ); }
+        uint128_t by_reserve1() const { return get_token_key( reserve1.get_extended_symbol() ); }
+        checksum256 by_tokens() const { return get_pair_key( reserve0.get_extended_symbol(), reserve1.get_extended_symbol() ); }
     };
-    typedef eosio::multi_index< "pairs"_n, pairs_row> pairs_table;
+    typedef eosio::multi_index< "pairs"_n, pairs_row,
+        indexed_by< "byreserve0"_n, const_mem_fun<pairs_row, uint128_t, &pairs_row::by_reserve0> >,
+        indexed_by< "byreserve1"_n, const_mem_fun<pairs_row, uint128_t, &pairs_row::by_reserve1> >,
+        indexed_by< "bytokens"_n, const_mem_fun<pairs_row, checksum256, &pairs_row::by_tokens> >
+    > pairs_table;
 
     /**
-     * ## TABLE `ramp`
+     * ## TABLE `pools`
+     *
+     * StableSwap pools of 3 to 4 coins (ex: USDT/USN/USDC), ids are shared with `pairs`
+     *
+     * - `{symbol_code} id` - pool id
+     * - `{vector<extended_asset>} reserves` - reserve assets
+     * - `{extended_asset} liquidity` - liquidity asset
+     * - `{uint64_t} amplifier` - amplifier
+     * - `{uint64_t} virtual_price` - reserves relative to liquidity supply (scaled by `Curve::PRICE_SCALE`)
+     * - `{vector<asset>} volumes` - cumulative incoming trading volume per reserve
+     * - `{uint64_t} trades` - cumulative trades count
+     * - `{time_point_sec} last_updated` - last updated timestamp
+     * - `{uint64_t} invariant` - StableSwap invariant D of reserves (normalized to `MAX_PRECISION`)
+     * - `{uint64_t} invariant_amplifier` - amplifier used to calculate `invariant`
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "id": "ABC",
+     *   "reserves": [
+     *     {"quantity": "1000.0000 A", "contract": "eosio.token"},
+     *     {"quantity": "1000.0000 B", "contract": "eosio.token"},
+     *     {"quantity": "1000.000000000 C", "contract": "eosio.token"}
+     *   ],
+     *   "liquidity": {"quantity": "3000.000000000 ABC", "contract": "lptoken.sx"},
+     *   "amplifier": 450,
+     *   "virtual_price": 1000000000,
+     *   "volumes": ["100.0000 A", "0.0000 B", "0.000000000 C"],
+     *   "trades": 123,
+     *   "last_updated": "2020-11-23T00:00:00",
+     *   "invariant": 3000000000000,
+     *   "invariant_amplifier": 450
+     * }
+     * ```
+     */
+    struct [[eosio::table("pools")]] pools_row {
+        symbol_code                 id;
+        vector<extended_asset>      reserves;
+        extended_asset              liquidity;
+        uint64_t                    amplifier;
+        uint64_t                    virtual_price;
+        vector<asset>               volumes;
+        uint64_t                    trades;
+        time_point_sec              last_updated;
+        uint64_t                    invariant;
+        uint64_t                    invariant_amplifier;
+
+        uint64_t primary_key() const { return id.raw(); }
+    };
+    typedef eosio::multi_index< "pools"_n, pools_row> pools_table;
+
+    /**
+     * ## TABLE `poolorders`
+     *
+     * *scope*: `pool_id` (symbol_code)
+     *
+     * - `{name} owner` - owner account
+     * - `{vector<extended_asset>} quantities` - quantity assets (same order as pool `reserves`)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "owner": "myaccount",
+     *   "quantities": [
+     *     {"contract": "eosio.token", "quantity": "1000.0000 A"},
+     *     {"contract": "eosio.token", "quantity": "1000.0000 B"},
+     *     {"contract": "eosio.token", "quantity": "1000.000000000 C"}
+     *   ]
+     * }
+     * ```
+     */
+    struct [[eosio::table("poolorders")]] poolorders_row {
+        name                        owner;
+        vector<extended_asset>      quantities;
+
+        uint64_t primary_key() const { return owner.value; }
+    };
+    typedef eosio::multi_index< "poolorders"_n, poolorders_row> poolorders_table;
+
+    /**
+     * ## TABLE `fees`
+     *
+     * Protocol fees accrued during swaps, paid out to `config.fee_account` & erased by `claimfees` (in batches of `max_rows`, or per `token`)
+     *
+     * - `{uint64_t} id` - row id
+     * - `{extended_asset} balance` - accrued protocol fees
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "id": 0,
+     *   "balance": {"quantity": "0.0100 A", "contract": "eosio.token"}
+     * }
+     * ```
+     */
+    struct [[eosio::table("fees")]] fees_row {
+        uint64_t            id;
+        extended_asset      balance;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_token() const { return get_token_key( balance.get_extended_symbol() ); }
+    };
+    typedef eosio::multi_index< "fees"_n, fees_row,
+        indexed_by< "bytoken"_n, const_mem_fun<fees_row, uint128_t, &fees_row::by_token> >
+    > fees_table;
+
+    /**
+     * ## TABLE `balances`
+     *
+     * *scope*: `owner` (name)
+     *
+     * Balances deposited with "batch" memo or credited by `expireorders` (`credit_owners` rejecting refunds), spent by `batchswap` orders (settled & cleared by `batchswap`, withdrawn by `batchswap` without orders)
+     *
+     * - `{uint64_t} id` - row id
+     * - `{extended_asset} balance` - deposited balance
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "id": 0,
+     *   "balance": {"quantity": "100.0000 A", "contract": "eosio.token"}
+     * }
+     * ```
+     */
+    struct [[eosio::table("balances")]] balances_row {
+        uint64_t            id;
+        extended_asset      balance;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_token() const { return get_token_key( balance.get_extended_symbol() ); }
+    };
+    typedef eosio::multi_index< "balances"_n, balances_row,
+        indexed_by< "bytoken"_n, const_mem_fun<balances_row, uint128_t, &balances_row::by_token> >
+    > balances_table;
+
+    /**
+     * ## TABLE `observations`
+     *
+     * Ring buffer of periodic pair observations (`OBSERVATION_SLOTS` rows, at most one per `observation_interval`), written by swaps
+     *
+     * *scope*: `pair_id` (symbol_code)
+     *
+     * - `{uint64_t} slot` - ring buffer slot (interval number modulo `OBSERVATION_SLOTS`)
+     * - `{time_point_sec} timestamp` - observation timestamp
+     * - `{uint64_t} virtual_price` - reserves relative to liquidity supply (scaled by `Curve::PRICE_SCALE`)
+     * - `{asset} reserve0` - reserve0 quantity
+     * - `{asset} reserve1` - reserve1 quantity
+     * - `{asset} volume0` - cumulative incoming trading volume for reserve0
+     * - `{asset} volume1` - cumulative incoming trading volume for reserve1
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "slot": 17,
+     *   "timestamp": "2020-11-23T17:00:05",
+     *   "virtual_price": 1000200000,
+     *   "reserve0": "1000.0000 A",
+     *   "reserve1": "1000.0000 B",
+     *   "volume0": "100.0000 A",
+     *   "volume1": "100.0000 B"
+     * }
+     * ```
+     */
+    struct [[eosio::table("observations")]] observations_row {
+        uint64_t            slot;
+        time_point_sec      timestamp;
+        uint64_t            virtual_price;
+        asset               reserve0;
+        asset               reserve1;
+        asset               volume0;
+        asset               volume1;
+
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "observations"_n, observations_row> observations_table;
+
+    /**
+     * ## STRUCT `memo_schema`
+     *
+     * - `{name} action` - action name ("swap", "swapout", "swappool", "deposit", "withdrawone", "batch")
+     * - `{vector<symbol_code>} pair_ids` - symbol codes pair ids (pool id for "swappool")
+     * - `{int64_t} min_return` - minimum return amount expected (exact output amount for "swapout")
+     * - `{int64_t} max_in` - maximum input amount to spend ("swapout" only)
+     * - `{symbol_code} symcode_out` - output symbol code ("swappool", "withdrawone" & "swap" auto route only)
+     * - `{bool} instant` - deposit is issued by the transfer itself ("deposit,<pair_id>,<min_return>")
+     * - `{vector<vector<symbol_code>>} legs` - split routes ("swap" split only)
+     * - `{vector<uint64_t>} weights` - split routes weights in percent (empty when optimized)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "action": "swap",
+     *   "pair_ids": ["AB", "BC"],
+     *   "min_return": 100,
+     *   "max_in": 0,
+     *   "symcode_out": "",
+     *   "instant": false,
+     *   "legs": [],
+     *   "weights": []
+     * }
+     * ```
+     */
+    struct memo_schema {
+        name                    action;
+        vector<symbol_code>     pair_ids;
+        int64_t                 min_return;
+        int64_t                 max_in;
+        symbol_code             symcode_out;
+        bool                    instant;
+        vector<vector<symbol_code>> legs;
+        vector<uint64_t>        weights;
+    };
+
+    /**
+     * ## STRUCT `trade_record`
+     *
+     * - `{symbol_code} pair_id` - pair id (or pool id)
+     * - `{asset} quantity_in` - input quantity
+     * - `{asset} quantity_out` - output quantity
+     * - `{asset} fee` - trade & protocol fee
+     * - `{uint64_t} trade_price` - trade price, input per output (scaled by `Curve::PRICE_SCALE`)
+     * - `{asset} reserve0` - post-trade reserve0 (input reserve for pools)
+     * - `{asset} reserve1` - post-trade reserve1 (output reserve for pools)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "pair_id": "AB",
+     *   "quantity_in": "10.0000 A",
+     *   "quantity_out": "9.9950 B",
+     *   "fee": "0.0040 A",
+     *   "trade_price": 1000500250,
+     *   "reserve0": "1010.0000 A",
+     *   "reserve1": "990.0050 B"
+     * }
+     * ```
+     */
+    struct trade_record {
+        symbol_code             pair_id;
+        asset                   quantity_in;
+        asset                   quantity_out;
+        asset                   fee;
+        uint64_t                trade_price;
+        asset                   reserve0;
+        asset                   reserve1;
+    };
+
+    /**
+     * ## STRUCT `quote_request`
+     *
+     * - `{asset} in` - input quantity
+     * - `{vector<symbol_code>} pair_ids` - swap path (same as "swap" memo)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "in": "10.0000 A",
+     *   "pair_ids": ["AB", "BC"]
+     * }
+     * ```
+     */
+    struct quote_request {
+        asset                   in;
+        vector<symbol_code>     pair_ids;
+    };
+
+    /**
+     * ## STRUCT `quote_result`
+     *
+     * - `{asset} out` - output quantity of last hop
+     * - `{vector<trade_record>} trades` - per-hop quantities, fees, prices & post-trade reserves
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "out": "9.9950 B",
+     *   "trades": [{ "pair_id": "AB", "quantity_in": "10.0000 A", "quantity_out": "9.9950 B", ... }]
+     * }
+     * ```
+     */
+    struct quote_result {
+        asset                   out;
+        vector<trade_record>    trades;
+    };
+
+    /**
+     * ## STRUCT `deposit_result`
+     *
+     * - `{asset} issued` - liquidity issued
+     * - `{asset} deposit0` - reserve0 quantity added to reserves
+     * - `{asset} deposit1` - reserve1 quantity added to reserves
+     * - `{asset} excess0` - reserve0 quantity refunded (outside reserves ratio)
+     * - `{asset} excess1` - reserve1 quantity refunded (outside reserves ratio)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "issued": "20.0000 AB",
+     *   "deposit0": "10.0000 A",
+     *   "deposit1": "10.0000 B",
+     *   "excess0": "0.0000 A",
+     *   "excess1": "5.0000 B"
+     * }
+     * ```
+     */
+    struct deposit_result {
+        asset                   issued;
+        asset                   deposit0;
+        asset                   deposit1;
+        asset                   excess0;
+        asset                   excess1;
+    };
+
+    /**
+     * ## STRUCT `withdraw_result`
+     *
+     * - `{asset} out0` - reserve0 quantity paid out
+     * - `{asset} out1` - reserve1 quantity paid out
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "out0": "10.0000 A",
+     *   "out1": "10.0000 B"
+     * }
+     * ```
+     */
+    struct withdraw_result {
+        asset                   out0;
+        asset                   out1;
+    };
+
+    /**
+     * ## STRUCT `batch_order`
+     *
+     * - `{extended_asset} in` - input quantity (spent from `balances`)
+     * - `{vector<symbol_code>} pair_ids` - swap path (same as "swap" memo)
+     * - `{int64_t} min_return` - minimum return amount expected
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *   "in": {"quantity": "10.0000 A", "contract": "eosio.token"},
+     *   "pair_ids": ["AB"],
+     *   "min_return": 0
+     * }
+     * ```
+     */
+    struct batch_order {
+        extended_asset          in;
+        vector<symbol_code>     pair_ids;
+        int64_t                 min_return;
+    };
+
+    // USER
+    [[eosio::action]]
+    void deposit( const name owner, const symbol_code pair_id );
+
+    [[eosio::action]]
+    void cancel( const name owner, const symbol_code pair_id );
+
+    [[eosio::action]]
+    void cancelall( const name owner );
+
+    [[eosio::action]]
+    void expireorders( const uint64_t max_rows, const vector<name> credit_owners );
+
+    [[eosio::action]]
+    void batchswap( const name owner, const vector<batch_order> orders );
+
+    [[eosio::on_notify("*::transfer")]]
+    void on_transfer( const name from, const name to, const asset quantity, const std::string memo );
+
+    // ADMIN
+    [[eosio::action]]
+    void createpair( const name creator, const symbol_code pair_id, const extended_symbol reserve0, const extended_symbol reserve1, const uint64_t amplifier );
+
+    [[eosio::action]]
+    void removepair( const symbol_code pair_id );
+
+    [[eosio::action]]
+    void createpool( const name creator, const symbol_code pool_id, const vector<extended_symbol> reserves, const uint64_t amplifier );
+
+    [[eosio::action]]
+    void removepool( const symbol_code pool_id );
+
+    [[eosio::action]]
+    void setfee( const uint8_t trade_fee, const optional<uint8_t> protocol_fee, const optional<name> fee_account );
+
+    [[eosio::action]]
+    void setstatus( const name status );
+
+    [[eosio::action]]
+    void setinterval( const uint32_t observation_interval );
+
+    [[eosio::action]]
+    void migrate( const uint64_t max_rows );
+
+    [[eosio::action]]
+    void claimfees( const uint64_t max_rows, const optional<extended_symbol> token );
+
+    [[eosio::action]]
+    void ramp( const symbol_code pair_id, const uint64_t target_amplifier, const int64_t minutes );
+
+    [[eosio::action]]
+    void stopramp( const symbol_code pair_id );
+
+    [[eosio::action]]
+    void liquiditylog( const symbol_code pair_id, const name owner, const name action, const asset liquidity, const asset quantity0, const asset quantity1, const asset total_liquidity, const asset reserve0, const asset reserve1, const name stats_account );
+
+    // deprecated (replaced by `tradelog`), no longer sent & kept as no-op for one release
+    [[eosio::action]]
+    void swaplog( const symbol_code pair_id, const name owner, const name action, const asset quantity_in, const asset quantity_out, const asset fee, const double trade_price, const asset reserve0, const asset reserve1 );
+
+    [[eosio::action]]
+    void tradelog( const name owner, const name action, const vector<trade_record> trades, const name stats_account );
+
+    [[eosio::action]]
+    void poollog( const symbol_code pool_id, const name owner, const name action, const asset liquidity, const vector<asset> quantities, const asset total_liquidity, const vector<asset> reserves, const name stats_account );
+
+    [[eosio::action]]
+    void calculate( const uint64_t amount, const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint64_t fee );
+
+    // READ-ONLY
+    [[eosio::action, eosio::read_only]]
+    vector<quote_result> quote( const vector<quote_request> requests );
+
+    [[eosio::action, eosio::read_only]]
+    vector<asset> depth( const symbol_code pair_id, const vector<asset> amounts_in );
+
+    [[eosio::action, eosio::read_only]]
+    uint64_t spotprice( const symbol_code pair_id, const symbol_code symcode_in );
+
+    [[eosio::action, eosio::read_only]]
+    deposit_result depositout( const symbol_code pair_id, const asset quantity0, const asset quantity1 );
+
+    [[eosio::action, eosio::read_only]]
+    withdraw_result withdrawout( const asset liquidity );
+
+    using deposit_action = eosio::action_wrapper<"deposit"_n, &sx::curve::deposit>;
+    using cancel_action = eosio::action_wrapper<"cancel"_n, &sx::curve::cancel>;
+    using cancelall_action = eosio::action_wrapper<"cancelall"_n, &sx::curve::cancelall>;
+    using expireorders_action = eosio::action_wrapper<"expireorders"_n, &sx::curve::expireorders>;
+    using batchswap_action = eosio::action_wrapper<"batchswap"_n, &sx::curve::batchswap>;
+    using createpair_action = eosio::action_wrapper<"createpair"_n, &sx::curve::createpair>;
+    using removepair_action = eosio::action_wrapper<"removepair"_n, &sx::curve::removepair>;
+    using createpool_action = eosio::action_wrapper<"createpool"_n, &sx::curve::createpool>;
+    using removepool_action = eosio::action_wrapper<"removepool"_n, &sx::curve::removepool>;
+    using setfee_action = eosio::action_wrapper<"setfee"_n, &sx::curve::setfee>;
+    using setstatus_action = eosio::action_wrapper<"setstatus"_n, &sx::curve::setstatus>;
+    using setinterval_action = eosio::action_wrapper<"setinterval"_n, &sx::curve::setinterval>;
+    using migrate_action = eosio::action_wrapper<"migrate"_n, &sx::curve::migrate>;
+    using claimfees_action = eosio::action_wrapper<"claimfees"_n, &sx::curve::claimfees>;
+    using ramp_action = eosio::action_wrapper<"ramp"_n, &sx::curve::ramp>;
+    using stopramp_action = eosio::action_wrapper<"stopramp"_n, &sx::curve::stopramp>;
+    using liquiditylog_action = eosio::action_wrapper<"liquiditylog"_n, &sx::curve::liquiditylog>;
+    using swaplog_action = eosio::action_wrapper<"swaplog"_n, &sx::curve::swaplog>;
+    using tradelog_action = eosio::action_wrapper<"tradelog"_n, &sx::curve::tradelog>;
+    using poollog_action = eosio::action_wrapper<"poollog"_n, &sx::curve::poollog>;
+    using calculate_action = eosio::action_wrapper<"calculate"_n, &sx::curve::calculate>;
+    using quote_action = eosio::action_wrapper<"quote"_n, &sx::curve::quote>;
+    using depth_action = eosio::action_wrapper<"depth"_n, &sx::curve::depth>;
+    using spotprice_action = eosio::action_wrapper<"spotprice"_n, &sx::curve::spotprice>;
+    using depositout_action = eosio::action_wrapper<"depositout"_n, &sx::curve::depositout>;
+    using withdrawout_action = eosio::action_wrapper<"withdrawout"_n, &sx::curve::withdrawout>;
+
+    /**
+     * ## STATIC `get_amplifier`
+     *
+     * Retrieve current amplifier for pair
+     *
+     * ### params
+     *
+     * - `{symbol_code} pair_id` - pair id
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     *
+     * ### example
+     *
+     * ```c++
+     * const symbol_code pair_id = symbol_code {"SXA"};
+     * const uint64_t amplifier  = sx::curve::get_amplifier( pair_id );
+     * //=> 100
+     * ```
+     */
+    static uint64_t get_amplifier( const symbol_code pair_id )
+    {
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+
+        return get_amplifier( _pairs.get( pair_id.raw(), "curve.sx::get_amplifier: invalid `pair_id`" ) );
+    }
+
+    /**
+     * ## STATIC `get_ramp`
+     *
+     * Retrieve amplifier ramp of pair, from legacy `ramp` table for rows not yet migrated (see `migrate`)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pairs` - pair
+     *
+     * ### returns
+     *
+     * - `{ramp_params}` - amplifier ramp (`target_amplifier` is 0 if no ramp exists)
+     */
+    static ramp_params get_ramp( const pairs_row& pairs )
+    {
+        if ( pairs.ramp.has_value() ) return pairs.ramp.value();
+
+        sx::curve::ramp_table _ramp( sx::curve::code, sx::curve::code.value );
+        auto itr = _ramp.find( pairs.id.raw() );
+        if ( itr == _ramp.end() ) return ramp_params{};
+        return ramp_params{ itr->start_amplifier, itr->target_amplifier, itr->start_time, itr->end_time };
+    }
+
+    /**
+     * ## STATIC `get_amplifier`
+     *
+     * Retrieve current amplifier for already loaded pair (no table reads once ramp is stored inline, see `get_ramp`)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pairs` - pair
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - current amplifier
+     */
+    static uint64_t get_amplifier( const pairs_row& pairs )
+    {
+        // if no ramp exists, use pair's amplifier
+        const ramp_params ramp = get_ramp( pairs );
+        if ( !ramp.target_amplifier ) return pairs.amplifier;
+
+        const uint32_t now = current_time_point().sec_since_epoch();
+        const uint32_t t1 = ramp.end_time.sec_since_epoch();
+        const uint64_t A1 = ramp.target_amplifier;
+
+        // ramping up or down amplifier
+        if ( now < t1 ) {
+            const uint64_t A0 = ramp.start_amplifier;
+            const uint32_t t0 = ramp.start_time.sec_since_epoch();
+
+            // ramp down if future amplifier is smaller than initial amplifier
+            if ( A1 > A0 ) return A0 + (A1 - A0) * (now - t0) / (t1 - t0);
+            else return A0 - (A0 - A1) * (now - t0) / (t1 - t0);
+
+        // ramp up has reached maximum limit
+        } else return A1;
+    }
+
+    /**
+     * ## STATIC `get_pair_ids`
+     *
+     * Retrieve pairs holding {token} as reserve (`byreserve0` & `byreserve1` index lookups)
+     *
+     * ### params
+     *
+     * - `{extended_symbol} token` - reserve extended symbol
+     *
+     * ### returns
+     *
+     * - `{vector<symbol_code>}` - pair ids
+     *
+     * ### example
+     *
+     * ```c++
+     * const extended_symbol token = extended_symbol{ {"USDT", 4}, "tethertether"_n };
+     * const vector<symbol_code> pair_ids = sx::curve::get_pair_ids( token );
+     * //=> ["SXA", "SXB"]
+     * ```
+     */
+    static vector<symbol_code> get_pair_ids( const extended_symbol token )
+    {
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        const uint128_t key = get_token_key( token );
+
+        vector<symbol_code> pair_ids;
+        auto _pairs_by_reserve0 = _pairs.get_index<"byreserve0"_n>();
+        for ( auto itr = _pairs_by_reserve0.lower_bound( key ); itr != _pairs_by_reserve0.end() && itr->by_reserve0() == key; ++itr ) {
+            pair_ids.push_back( itr->id );
+        }
+        auto _pairs_by_reserve1 = _pairs.get_index<"byreserve1"_n>();
+        for ( auto itr = _pairs_by_reserve1.lower_bound( key ); itr != _pairs_by_reserve1.end() && itr->by_reserve1() == key; ++itr ) {
+            pair_ids.push_back( itr->id );
+        }
+        return pair_ids;
+    }
+
+    /**
+     * ## STATIC `get_pair_id`
+     *
+     * Retrieve pair of {token0} & {token1} reserves in any order (`bytokens` index point lookup)
+     *
+     * ### params
+     *
+     * - `{extended_symbol} token0` - reserve extended symbol
+     * - `{extended_symbol} token1` - reserve extended symbol
+     *
+     * ### returns
+     *
+     * - `{symbol_code}` - pair id (empty if no such pair)
+     *
+     * ### example
+     *
+     * ```c++
+     * const extended_symbol token0 = extended_symbol{ {"USDT", 4}, "tethertether"_n };
+     * const extended_symbol token1 = extended_symbol{ {"USN", 4}, "danchortoken"_n };
+     * const symbol_code pair_id = sx::curve::get_pair_id( token0, token1 );
+     * //=> "SXA"
+     * ```
+     */
+    static symbol_code get_pair_id( const extended_symbol token0, const extended_symbol token1 )
+    {
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        auto _pairs_by_tokens = _pairs.get_index<"bytokens"_n>();
+        auto itr = _pairs_by_tokens.find( get_pair_key( token0, token1 ) );
+
+        return itr == _pairs_by_tokens.end() ? symbol_code{} : itr->id;
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Calculate return for converting {in} amount via {pair_id} pool
+     *
+     * ### params
+     *
+     * - `{asset} in` - input token quantity
+     * - `{symbol_code} pair_id` - pair id
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset in = asset{10'0000, {"A", 4}};
+     * const symbol_code pair_id = symbol_code{"SXA"};
+     *
+     * const asset out = sx::curve::get_amount_out( in, pair_id );
+     * //=> "10.1000 B"
+     * ```
+     */
+    static asset get_amount_out( const asset in, const symbol_code pair_id )
+    {
+        sx::curve::config_table _config( sx::curve::code, sx::curve::code.value );
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+
+        // get configs
+        const auto config = _config.get();
+        const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::get_amount_out: invalid pair id" );
+
+        return get_amount_out( in, pairs, config, get_amplifier( pairs ) );
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Calculate return for converting {in} amount via already loaded {pairs} row, {config} & current {amplifier}
+     *
+     * ### params
+     *
+     * - `{asset} in` - input token quantity
+     * - `{pairs_row} pairs` - pair
+     * - `{config_row} config` - config
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     */
+    static asset get_amount_out( const asset in, pairs_row pairs, const config_row& config, const uint64_t amplifier )
+    {
+        // inverse reserves based on input quantity
+        if (pairs.reserve0.quantity.symbol != in.symbol) pairs.inverse_reserves();
+        eosio::check( pairs.reserve0.quantity.symbol == in.symbol, "curve.sx::get_amount_out: no such reserve in pairs");
+
+        // normalize inputs to max precision
+        const int64_t amount_in = mul_scale( in.amount, pairs.get_scale0() );
+        const int64_t reserve_in = pairs.get_reserve0();
+        const int64_t reserve_out = pairs.get_reserve1();
+        const int64_t protocol_fee = amount_in * config.protocol_fee / 10000;
+
+        // cached invariant is exact if computed with current amplifier
+        const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+
+        // enforce minimum fee
+        if ( config.trade_fee ) check( in.amount * config.trade_fee / 10000, "curve.sx::get_amount_out: trade quantity too small");
+
+        // calculate out
+        const int64_t out = static_cast<int64_t>(Curve::get_amount_out( amount_in - protocol_fee, reserve_in, reserve_out, amplifier, config.trade_fee, D_hint )) / pairs.get_scale1();
+
+        return { out, pairs.reserve1.quantity.symbol };
+    }
+
+    /**
+     * ## STATIC `get_depth_ladder`
+     *
+     * Calculate returns for converting each of ascending {amounts_in} via {pair_id} pool (output-vs-input curve)
+     *
+     * ### params
+     *
+     * - `{vector<asset>} amounts_in` - ascending input token quantities (same symbol)
+     * - `{symbol_code} pair_id` - pair id
+     *
+     * ### returns
+     *
+     * - `{vector<asset>}` - calculated returns
+     *
+     * ### example
+     *
+     * ```c++
+     * const vector<asset> amounts_in = { asset{1'0000, {"A", 4}}, asset{10'0000, {"A", 4}}, asset{100'0000, {"A", 4}} };
+     * const symbol_code pair_id = symbol_code{"SXA"};
+     *
+     * const vector<asset> amounts_out = sx::curve::get_depth_ladder( amounts_in, pair_id );
+     * //=> ["1.0010 B", "10.0100 B", "100.0900 B"]
+     * ```
+     */
+    static vector<asset> get_depth_ladder( const vector<asset>& amounts_in, const symbol_code pair_id )
+    {
+        sx::curve::config_table _config( sx::curve::code, sx::curve::code.value );
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+
+        // get configs
+        const auto config = _config.get();
+        const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::get_depth_ladder: invalid pair id" );
+
+        return get_depth_ladder( amounts_in, pairs, config, get_amplifier( pairs ) );
+    }
+
+    /**
+     * ## STATIC `get_depth_ladder`
+     *
+     * Calculate returns for converting each of ascending {amounts_in} via already loaded {pairs} row, {config} & current {amplifier}
+     * Invariant is solved once for all points (see `Curve::get_depth_ladder`), each point matches `get_amount_out`
+     *
+     * ### params
+     *
+     * - `{vector<asset>} amounts_in` - ascending input token quantities (same symbol)
+     * - `{pairs_row} pairs` - pair
+     * - `{config_row} config` - config
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{vector<asset>}` - calculated returns
+     */
+    static vector<asset> get_depth_ladder( const vector<asset>& amounts_in, pairs_row pairs, const config_row& config, const uint64_t amplifier )
+    {
+        check( amounts_in.size(), "curve.sx::get_depth_ladder: `amounts_in` cannot be empty");
+        const symbol sym_in = amounts_in[0].symbol;
+
+        // inverse reserves based on input quantity
+        if (pairs.reserve0.quantity.symbol != sym_in) pairs.inverse_reserves();
+        eosio::check( pairs.reserve0.quantity.symbol == sym_in, "curve.sx::get_depth_ladder: no such reserve in pairs");
+
+        // normalize inputs to max precision (net of protocol fee)
+        const int64_t scale_in = pairs.get_scale0();
+        const int64_t scale_out = pairs.get_scale1();
+        const int64_t reserve_in = pairs.get_reserve0();
+        const int64_t reserve_out = pairs.get_reserve1();
+        std::vector<uint64_t> amounts;
+        amounts.reserve( amounts_in.size() );
+        for ( const asset& in : amounts_in ) {
+            check( in.symbol == sym_in, "curve.sx::get_depth_ladder: input symbols must match");
+            if ( config.trade_fee ) check( in.amount * config.trade_fee / 10000, "curve.sx::get_depth_ladder: trade quantity too small");
+            const int64_t amount_in = mul_scale( in.amount, scale_in );
+            amounts.push_back( amount_in - amount_in * config.protocol_fee / 10000 );
+        }
+
+        // cached invariant is exact if computed with current amplifier
+        const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+
+        // calculate outs
+        vector<asset> amounts_out;
+        amounts_out.reserve( amounts.size() );
+        for ( const uint64_t out : Curve::get_depth_ladder<2>( amounts, 0, 1, {static_cast<uint64_t>(reserve_in), static_cast<uint64_t>(reserve_out)}, amplifier, config.trade_fee, D_hint ) ) {
+            amounts_out.push_back({ static_cast<int64_t>(out) / scale_out, pairs.reserve1.quantity.symbol });
+        }
+        return amounts_out;
+    }
+
+    /**
+     * ## STATIC `get_spot_price`
+     *
+     * Calculate marginal rate of {symcode_in} reserve quoted in the other reserve of {pair_id} pool (before fees)
+     *
+     * ### params
+     *
+     * - `{symbol_code} pair_id` - pair id
+     * - `{symbol_code} symcode_in` - priced reserve symbol code
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - spot price scaled by `Curve::PRICE_SCALE` (1e9)
+     *
+     * ### example
+     *
+     * ```c++
+     * const symbol_code pair_id = symbol_code{"SXA"};
+     * const symbol_code symcode_in = symbol_code{"USDT"};
+     *
+     * const uint64_t price = sx::curve::get_spot_price( pair_id, symcode_in );
+     * //=> 1001497755 (1.001497755 USN per USDT)
+     * ```
+     */
+    static uint64_t get_spot_price( const symbol_code pair_id, const symbol_code symcode_in )
+    {
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::get_spot_price: invalid pair id" );
+
+        return get_spot_price( pairs, symcode_in, get_amplifier( pairs ) );
+    }
+
+    /**
+     * ## STATIC `get_spot_price`
+     *
+     * Calculate marginal rate of {symcode_in} reserve of already loaded {pairs} row & current {amplifier} (see `Curve::get_spot_price`)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pairs` - pair
+     * - `{symbol_code} symcode_in` - priced reserve symbol code
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - spot price scaled by `Curve::PRICE_SCALE` (1e9)
+     */
+    static uint64_t get_spot_price( pairs_row pairs, const symbol_code symcode_in, const uint64_t amplifier )
+    {
+        // inverse reserves based on priced reserve
+        if (pairs.reserve0.quantity.symbol.code() != symcode_in) pairs.inverse_reserves();
+        eosio::check( pairs.reserve0.quantity.symbol.code() == symcode_in, "curve.sx::get_spot_price: no such reserve in pairs");
+
+        // normalize reserves to max precision
+        const int64_t reserve_in = pairs.get_reserve0();
+        const int64_t reserve_out = pairs.get_reserve1();
+
+        // cached invariant is exact if computed with current amplifier
+        const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+
+        return Curve::get_spot_price( reserve_in, reserve_out, amplifier, D_hint );
+    }
+
+    /**
+     * ## STATIC `get_virtual_price`
+     *
+     * Virtual price of already loaded {pairs} row as floating point (read-only helper, see `prices`)
+     *
+     * ### example
+     *
+     * ```c++
+     * const double virtual_price = sx::curve::get_virtual_price( pairs );
+     * //=> 1.0002
+     * ```
+     */
+    static double get_virtual_price( const pairs_row& pairs )
+    {
+        return pairs.prices.has_value() ? to_price( pairs.prices.value().virtual_price ) : pairs.virtual_price;
+    }
+
+    /**
+     * ## STATIC `get_price0_last`
+     *
+     * Last trade price of reserve0 of already loaded {pairs} row as floating point (read-only helper, see `prices`)
+     */
+    static double get_price0_last( const pairs_row& pairs )
+    {
+        return pairs.prices.has_value() ? to_price( pairs.prices.value().price0_last ) : pairs.price0_last;
+    }
+
+    /**
+     * ## STATIC `get_price1_last`
+     *
+     * Last trade price of reserve1 of already loaded {pairs} row as floating point (read-only helper, see `prices`)
+     */
+    static double get_price1_last( const pairs_row& pairs )
+    {
+        return pairs.prices.has_value() ? to_price( pairs.prices.value().price1_last ) : pairs.price1_last;
+    }
+
+    /**
+     * ## STATIC `get_price_cumulative`
+     *
+     * Cumulative spot prices of already loaded {pairs} row accumulated up to {timestamp}
+     * Time elapsed since last pair write is accumulated at current spot prices (same calculation as pair writes)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pairs` - pair
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     * - `{time_point_sec} timestamp` - observation timestamp
+     *
+     * ### returns
+     *
+     * - `{oracle_params}` - cumulative prices at {timestamp}
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto& pairs = _pairs.get( symbol_code{"SXA"}.raw() );
+     * const auto observation = sx::curve::get_price_cumulative( pairs, sx::curve::get_amplifier( pairs ), current_time_point() );
+     * ```
+     */
+    static oracle_params get_price_cumulative( const pairs_row& pairs, const uint64_t amplifier, const time_point_sec timestamp )
+    {
+        oracle_params oracle = pairs.oracle.has_value() ? pairs.oracle.value() : oracle_params{ 0, 0, timestamp };
+        if ( timestamp <= oracle.timestamp ) return oracle;
+
+        // accumulate with wrap-around (only differences between observations are meaningful)
+        if ( pairs.reserve0.quantity.amount && pairs.reserve1.quantity.amount ) {
+            const uint128_t elapsed = timestamp.sec_since_epoch() - oracle.timestamp.sec_since_epoch();
+            const int64_t reserve0 = pairs.get_reserve0();
+            const int64_t reserve1 = pairs.get_reserve1();
+
+            // both directions are priced from one invariant, cached D is exact if computed with current amplifier
+            const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+            const uint64_t D = D_hint ? D_hint : Curve::get_invariant( reserve0, reserve1, amplifier );
+            oracle.price0_cumulative += elapsed * Curve::get_marginal_price( reserve0, reserve1, amplifier, D );
+            oracle.price1_cumulative += elapsed * Curve::get_marginal_price( reserve1, reserve0, amplifier, D );
+        }
+        oracle.timestamp = timestamp;
+        return oracle;
+    }
+
+    /**
+     * ## STATIC `get_twap`
+     *
+     * Time-weighted average spot prices between two observations (see `get_price_cumulative`)
+     *
+     * ### params
+     *
+     * - `{oracle_params} start` - earlier observation
+     * - `{oracle_params} end` - later observation
+     *
+     * ### returns
+     *
+     * - `{pair<uint64_t, uint64_t>}` - reserve0 & reserve1 average prices scaled by `Curve::PRICE_SCALE` (1e9)
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto [ price0, price1 ] = sx::curve::get_twap( start, end );
+     * //=> { 1000512345, 999487918 }
+     * ```
+     */
+    static std::pair<uint64_t, uint64_t> get_twap( const oracle_params& start, const oracle_params& end )
+    {
+        check( end.timestamp > start.timestamp, "curve.sx::get_twap: `end` must be after `start`");
+        const uint32_t elapsed = end.timestamp.sec_since_epoch() - start.timestamp.sec_since_epoch();
+
+        return { static_cast<uint64_t>( (end.price0_cumulative - start.price0_cumulative) / elapsed ),
+                 static_cast<uint64_t>( (end.price1_cumulative - start.price1_cumulative) / elapsed ) };
+    }
+
+    /**
+     * ## STATIC `get_observation`
+     *
+     * Pair observation at {timestamp}, linearly interpolated between the two surrounding `observations` rows
+     *
+     * ### params
+     *
+     * - `{symbol_code} pair_id` - pair id
+     * - `{time_point_sec} timestamp` - observation time (within recorded observations)
+     *
+     * ### returns
+     *
+     * - `{observations_row}` - interpolated virtual price, reserves & cumulative volumes
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto now = sx::curve::get_observation( symbol_code{"SXA"}, current_time_point() - hours(1) );
+     * const auto day = sx::curve::get_observation( symbol_code{"SXA"}, current_time_point() - days(1) );
+     * const asset volume = now.volume0 - day.volume0;
+     * ```
+     */
+    static observations_row get_observation( const symbol_code pair_id, const time_point_sec timestamp )
+    {
+        sx::curve::observations_table _observations( sx::curve::code, pair_id.raw() );
+        return get_observation( vector<observations_row>{ _observations.begin(), _observations.end() }, timestamp );
+    }
+
+    /**
+     * ## STATIC `get_observation`
+     *
+     * Pair observation at {timestamp} from already loaded {observations} rows (any order)
+     *
+     * ### params
+     *
+     * - `{vector<observations_row>} observations` - recorded observations
+     * - `{time_point_sec} timestamp` - observation time (within recorded observations)
+     *
+     * ### returns
+     *
+     * - `{observations_row}` - interpolated virtual price, reserves & cumulative volumes
+     */
+    static observations_row get_observation( const vector<observations_row>& observations, const time_point_sec timestamp )
+    {
+        // closest observations before & after timestamp
+        const observations_row* before = nullptr;
+        const observations_row* after = nullptr;
+        for ( const observations_row& row : observations ) {
+            if ( row.timestamp <= timestamp && ( !before || row.timestamp > before->timestamp ) ) before = &row;
+            if ( row.timestamp >= timestamp && ( !after || row.timestamp < after->timestamp ) ) after = &row;
+        }
+        check( before && after, "curve.sx::get_observation: `timestamp` is outside of recorded observations");
+        if ( before->timestamp == after->timestamp ) return *before;
+
+        // linear interpolation
+        const int64_t elapsed = timestamp.sec_since_epoch() - before->timestamp.sec_since_epoch();
+        const int64_t period = after->timestamp.sec_since_epoch() - before->timestamp.sec_since_epoch();
+        const auto lerp = [&]( const asset a, const asset b ) -> asset {
+            return { a.amount + static_cast<int64_t>( static_cast<int128_t>( b.amount - a.amount ) * elapsed / period ), a.symbol };
+        };
+
+        observations_row result = *before;
+        result.timestamp = timestamp;
+        result.virtual_price = before->virtual_price + static_cast<int64_t>( (static_cast<int128_t>( after->virtual_price ) - before->virtual_price) * elapsed / period );
+        result.reserve0 = lerp( before->reserve0, after->reserve0 );
+        result.reserve1 = lerp( before->reserve1, after->reserve1 );
+        result.volume0 = lerp( before->volume0, after->volume0 );
+        result.volume1 = lerp( before->volume1, after->volume1 );
+        return result;
+    }
+
+    /**
+     * ## STATIC `get_trade`
+     *
+     * Calculate trade of {in} amount via already loaded {pairs} row, {config} & current {amplifier}
+     * Same calculation as executed swaps (see `apply_trade`), reserves are not modified
+     *
+     * ### params
+     *
+     * - `{asset} in` - input token quantity
+     * - `{pairs_row} pairs` - pair
+     * - `{config_row} config` - config
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{trade_record}` - output, fee, trade price & post-trade reserves
+     */
+    static trade_record get_trade( const asset in, const pairs_row& pairs, const config_row& config, const uint64_t amplifier )
+    {
+        const asset out = get_amount_out( in, pairs, config, amplifier );
+        const asset protocol_fee = { in.amount * config.protocol_fee / 10000, in.symbol };
+        const asset trade_fee = { in.amount * config.trade_fee / 10000, in.symbol };
+
+        // protocol fee is excluded from reserves (see `accrue_fee`)
+        asset reserve0 = pairs.reserve0.quantity;
+        asset reserve1 = pairs.reserve1.quantity;
+        if ( reserve0.symbol == in.symbol ) {
+            reserve0 += in - protocol_fee;
+            reserve1 -= out;
+        } else {
+            reserve1 += in - protocol_fee;
+            reserve0 -= out;
+        }
+        return { pairs.id, in, out, protocol_fee + trade_fee, calculate_price( in, out ), reserve0, reserve1 };
+    }
+
+    /**
+     * ## STATIC `get_withdraw_one_out`
+     *
+     * Calculate return for withdrawing {liquidity} entirely into the {symcode_out} reserve of its pair
+     *
+     * ### params
+     *
+     * - `{asset} liquidity` - liquidity token quantity (symbol code is the pair id)
+     * - `{symbol_code} symcode_out` - output reserve symbol code
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset liquidity = asset{10'0000, {"SXA", 4}};
+     * const symbol_code symcode_out = symbol_code{"USDT"};
+     *
+     * const asset out = sx::curve::get_withdraw_one_out( liquidity, symcode_out );
+     * //=> "9.9970 USDT"
+     * ```
+     */
+    static asset get_withdraw_one_out( const asset liquidity, const symbol_code symcode_out )
+    {
+        sx::curve::config_table _config( sx::curve::code, sx::curve::code.value );
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+
+        // get configs
+        const auto config = _config.get();
+        const auto& pairs = _pairs.get( liquidity.symbol.code().raw(), "curve.sx::get_withdraw_one_out: invalid pair id" );
+
+        return get_withdraw_one_out( liquidity, pairs, symcode_out, config, get_amplifier( pairs ) );
+    }
+
+    /**
+     * ## STATIC `get_withdraw_one_out`
+     *
+     * Calculate return for withdrawing {liquidity} into the {symcode_out} reserve of already loaded {pairs} row, {config} & current {amplifier}
+     *
+     * ### params
+     *
+     * - `{asset} liquidity` - liquidity token quantity
+     * - `{pairs_row} pairs` - pair
+     * - `{symbol_code} symcode_out` - output reserve symbol code
+     * - `{config_row} config` - config
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     */
+    static asset get_withdraw_one_out( const asset liquidity, pairs_row pairs, const symbol_code symcode_out, const config_row& config, const uint64_t amplifier )
+    {
+        eosio::check( pairs.liquidity.quantity.symbol == liquidity.symbol, "curve.sx::get_withdraw_one_out: invalid liquidity symbol");
+
+        // output reserve is always `reserve0`
+        if (pairs.reserve0.quantity.symbol.code() != symcode_out) pairs.inverse_reserves();
+        eosio::check( pairs.reserve0.quantity.symbol.code() == symcode_out, "curve.sx::get_withdraw_one_out: no such reserve in pairs");
+
+        // normalize inputs to max precision
+        const int64_t amount = mul_scale( liquidity.amount, pairs.get_scale_lp() );
+        const int64_t supply = pairs.get_supply();
+        const int64_t reserve_out = pairs.get_reserve0();
+        const int64_t reserve_other = pairs.get_reserve1();
+
+        // cached invariant is exact if computed with current amplifier (symmetric in reserves)
+        const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+
+        // calculate out
+        const int64_t out = static_cast<int64_t>(Curve::get_withdraw_one_out<2>( amount, supply, 0, {static_cast<uint64_t>(reserve_out), static_cast<uint64_t>(reserve_other)}, amplifier, config.trade_fee, D_hint )) / pairs.get_scale0();
+
+        return { out, pairs.reserve0.quantity.symbol };
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Calculate input required to receive at least {out} amount via {pair_id} pool
+     *
+     * ### params
+     *
+     * - `{asset} out` - output token quantity
+     * - `{symbol_code} pair_id` - pair id
+     *
+     * ### returns
+     *
+     * - `{asset}` - required input
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset out = asset{10'1000, {"B", 4}};
+     * const symbol_code pair_id = symbol_code{"SXA"};
+     *
+     * const asset in = sx::curve::get_amount_in( out, pair_id );
+     * //=> "10.0000 A"
+     * ```
+     */
+    static asset get_amount_in( const asset out, const symbol_code pair_id )
+    {
+        sx::curve::config_table _config( sx::curve::code, sx::curve::code.value );
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+
+        // get configs
+        const auto config = _config.get();
+        const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::get_amount_in: invalid pair id" );
+
+        return get_amount_in( out, pairs, config, get_amplifier( pairs ) );
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Calculate input required to receive at least {out} amount via already loaded {pairs} row, {config} & current {amplifier}
+     *
+     * ### params
+     *
+     * - `{asset} out` - output token quantity
+     * - `{pairs_row} pairs` - pair
+     * - `{config_row} config` - config
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     *
+     * ### returns
+     *
+     * - `{asset}` - required input
+     */
+    static asset get_amount_in( const asset out, pairs_row pairs, const config_row& config, const uint64_t amplifier )
+    {
+        // inverse reserves based on output quantity
+        if (pairs.reserve1.quantity.symbol != out.symbol) pairs.inverse_reserves();
+        eosio::check( pairs.reserve1.quantity.symbol == out.symbol, "curve.sx::get_amount_in: no such reserve in pairs");
+
+        // normalize inputs to max precision
+        const int64_t scale_in = pairs.get_scale0();
+        const int64_t scale_out = pairs.get_scale1();
+        const int64_t amount_out = mul_scale( out.amount, scale_out );
+        const int64_t reserve_in = pairs.get_reserve0();
+        const int64_t reserve_out = pairs.get_reserve1();
+        const uint64_t D_hint = pairs.get_invariant_hint( amplifier );
+
+        // calculate input after protocol fee, then input before protocol fee (rounded up to input precision)
+        const uint64_t amount_in = Curve::get_amount_in( amount_out, reserve_in, reserve_out, amplifier, config.trade_fee, D_hint );
+        const int64_t unit = scale_in;
+        int64_t in = static_cast<int64_t>( (uint128_t(amount_in) * 10000 + (10000 - config.protocol_fee) - 1) / (10000 - config.protocol_fee) );
+        in = (in + unit - 1) / unit;
+
+        // round up until forward calculation (see `get_amount_out`) reaches {out}
+        int i = Curve::MAX_ITERATIONS;
+        while ( true ) {
+            const int64_t amount = mul_scale( in, scale_in );
+            const int64_t protocol_fee = amount * config.protocol_fee / 10000;
+            const uint64_t amount_out_fwd = Curve::get_amount_out( amount - protocol_fee, reserve_in, reserve_out, amplifier, config.trade_fee, D_hint );
+            if ( static_cast<int64_t>(amount_out_fwd) / scale_out >= out.amount ) break;
+            check( i-- > 0, "curve.sx::get_amount_in: failed to converge");
+            in += 1;
+        }
+
+        // enforce minimum fee
+        if ( config.trade_fee ) check( in * config.trade_fee / 10000, "curve.sx::get_amount_in: trade quantity too small");
+
+        return { in, pairs.reserve0.quantity.symbol };
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Calculate input required to receive at least {out} amount via multiple {pair_ids} pools (reverse order from last pool)
+     *
+     * ### params
+     *
+     * - `{asset} out` - output token quantity of last pool
+     * - `{vector<symbol_code>} pair_ids` - pair ids (swap path)
+     *
+     * ### returns
+     *
+     * - `{asset}` - required input of first pool
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset out = asset{10'000000000, {"C", 9}};
+     * const vector<symbol_code> pair_ids = { symbol_code{"AB"}, symbol_code{"BC"} };
+     *
+     * const asset in = sx::curve::get_amount_in( out, pair_ids );
+     * //=> "10.0213 A"
+     * ```
+     */
+    static asset get_amount_in( const asset out, const vector<symbol_code> pair_ids )
+    {
+        asset quantity = out;
+        for ( auto itr = pair_ids.rbegin(); itr != pair_ids.rend(); ++itr ) {
+            quantity = get_amount_in( quantity, *itr );
+        }
+        return quantity;
+    }
+
+    /**
+     * ## STATIC `get_invariant`
+     *
+     * Calculate StableSwap invariant D of pair reserves (normalized to `MAX_PRECISION`)
+     * Newton iteration is warm-started from the pair's cached `invariant`
+     *
+     * ### params
+     *
+     * - `{pairs_row} pair` - pair
+     * - `{uint64_t} amplifier` - amplifier
+     *
+     * ### returns
      *
-     * - `{symbol_code} id` - pair id
-     * - `{uint64_t} start_amplifier` - start amplifier when `ramp` action is initialized
-     * - `{uint64_t} target_amplifier` - target amplifier when end time is reached
-     * - `{time_point_sec} start_time` - start time when `ramp` action is initialized
-     * - `{time_point_sec} end_time` - end time when target amplifier will be reached
+     * - `{uint64_t}` - invariant D (0 if reserves are empty)
      *
      * ### example
      *
-     * ```json
-     * {
-     *   "id": "AB",
-     *   "start_amplifier": 100,
-     *   "target_amplifier": 200,
-     *   "start_time": "2021-02-03T00:00:00"
-     *   "end_time": "2021-02-04T00:00:00"
-     * }
+     * ```c++
+     * const uint64_t invariant = sx::curve::get_invariant( pair, amplifier );
+     * //=> 2000000000000
      * ```
      */
-    struct [[eosio::table("ramp")]] ramp_row {
-        symbol_code         pair_id;
-        uint64_t            start_amplifier;
-        uint64_t            target_amplifier;
-        time_point_sec      start_time;
-        time_point_sec      end_time;
+    static uint64_t get_invariant( const pairs_row& pair, const uint64_t amplifier )
+    {
+        if ( !pair.reserve0.quantity.amount || !pair.reserve1.quantity.amount ) return 0;
 
-        uint64_t primary_key() const { return pair_id.raw(); }
-    };
-    typedef eosio::multi_index< "ramp"_n, ramp_row> ramp_table;
+        return Curve::get_invariant( pair.get_reserve0(), pair.get_reserve1(), amplifier, pair.invariant.value_or( 0 ) );
+    }
 
     /**
-     * ## STRUCT `memo_schema`
+     * ## STATIC `get_imbalanced_deposit_out`
      *
-     * - `{name} action` - action name ("swap", "deposit")
-     * - `{vector<symbol_code>} pair_ids` - symbol codes pair ids
-     * - `{int64_t} min_return` - minimum return amount expected
+     * Calculate liquidity issued for an imbalanced (or single-sided) deposit of {quantity0} & {quantity1} into {pair}
+     * Issued liquidity is based on the invariant increase net of the imbalance fee (see `Curve::get_deposit_invariant`)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pair` - pair (reserves & liquidity must not be empty)
+     * - `{asset} quantity0` - deposit quantity of reserve0 (can be zero)
+     * - `{asset} quantity1` - deposit quantity of reserve1 (can be zero)
+     * - `{uint64_t} amplifier` - current amplifier (see `get_amplifier`)
+     * - `{uint8_t} trade_fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{asset}` - issued liquidity
      *
      * ### example
      *
-     * ```json
-     * {
-     *   "action": "swap",
-     *   "pair_ids": ["AB", "BC"],
-     *   "min_return": 100
-     * }
+     * ```c++
+     * const asset liquidity = sx::curve::get_imbalanced_deposit_out( pair, asset{10'0000, {"A", 4}}, asset{0, {"B", 4}}, 450, 4 );
+     * //=> "9.9980 AB"
      * ```
      */
-    struct memo_schema {
-        name                    action;
-        vector<symbol_code>     pair_ids;
-        int64_t                 min_return;
-    };
-
-    // USER
-    [[eosio::action]]
-    void deposit( const name owner, const symbol_code pair_id );
-
-    [[eosio::action]]
-    void cancel( const name owner, const symbol_code pair_id );
+    static asset get_imbalanced_deposit_out( const pairs_row& pair, const asset quantity0, const asset quantity1, const uint64_t amplifier, const uint8_t trade_fee )
+    {
+        const symbol sym0 = pair.reserve0.quantity.symbol;
+        const symbol sym1 = pair.reserve1.quantity.symbol;
+        const symbol sym_lp = pair.liquidity.quantity.symbol;
+        check( quantity0.symbol == sym0 && quantity1.symbol == sym1, "curve.sx::get_imbalanced_deposit_out: invalid deposit symbols");
+        check( quantity0.amount >= 0 && quantity1.amount >= 0 && quantity0.amount + quantity1.amount > 0, "curve.sx::get_imbalanced_deposit_out: invalid deposit amounts");
+        check( pair.reserve0.quantity.amount && pair.reserve1.quantity.amount && pair.liquidity.quantity.amount, "curve.sx::get_imbalanced_deposit_out: pair reserves must not be empty");
 
-    [[eosio::on_notify("*::transfer")]]
-    void on_transfer( const name from, const name to, const asset quantity, const std::string memo );
+        // normalize inputs to max precision
+        const uint64_t amount0 = mul_scale( quantity0.amount, pair.get_scale0() );
+        const uint64_t amount1 = mul_scale( quantity1.amount, pair.get_scale1() );
+        const uint64_t reserve0 = pair.get_reserve0();
+        const uint64_t reserve1 = pair.get_reserve1();
+        const uint64_t supply = pair.get_supply();
 
-    // ADMIN
-    [[eosio::action]]
-    void createpair( const name creator, const symbol_code pair_id, const extended_symbol reserve0, const extended_symbol reserve1, const uint64_t amplifier );
+        // invariant before & after deposit (net of imbalance fee)
+        const uint64_t D0 = Curve::get_invariant( reserve0, reserve1, amplifier, pair.get_invariant_hint( amplifier ) );
+        const uint64_t D2 = Curve::get_deposit_invariant<2>( {amount0, amount1}, {reserve0, reserve1}, amplifier, trade_fee, D0 );
+        if ( D2 <= D0 ) return { 0, sym_lp };
 
-    [[eosio::action]]
-    void removepair( const symbol_code pair_id );
+        // issue liquidity proportional to invariant increase
+        const int64_t issued = rex::issue( D2 - D0, D0, supply );
+        return { issued / pair.get_scale_lp(), sym_lp };
+    }
 
-    [[eosio::action]]
-    void setfee( const uint8_t trade_fee, const optional<uint8_t> protocol_fee, const optional<name> fee_account );
+    /**
+     * ## STATIC `get_deposit_out`
+     *
+     * Calculate liquidity issued for a balanced deposit of {quantity0} & {quantity1} into {pair_id} (same calculation as `deposit`)
+     *
+     * ### params
+     *
+     * - `{symbol_code} pair_id` - pair id
+     * - `{asset} quantity0` - deposit quantity of reserve0
+     * - `{asset} quantity1` - deposit quantity of reserve1
+     *
+     * ### returns
+     *
+     * - `{deposit_result}` - issued liquidity, deposited & refunded quantities
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto result = sx::curve::get_deposit_out( symbol_code{"SXA"}, asset{10'0000, {"USDT", 4}}, asset{15'0000, {"USN", 4}} );
+     * //=> { "issued": "20.0000 SXA", "deposit0": "10.0000 USDT", "deposit1": "10.0000 USN", "excess0": "0.0000 USDT", "excess1": "5.0000 USN" }
+     * ```
+     */
+    static deposit_result get_deposit_out( const symbol_code pair_id, const asset quantity0, const asset quantity1 )
+    {
+        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        const auto& pair = _pairs.get( pair_id.raw(), "curve.sx::get_deposit_out: invalid pair id" );
 
-    [[eosio::action]]
-    void setstatus( const name status );
+        return get_deposit_out( pair, quantity0, quantity1 );
+    }
 
-    [[eosio::action]]
-    void ramp( const symbol_code pair_id, const uint64_t target_amplifier, const int64_t minutes );
+    /**
+     * ## STATIC `get_deposit_out`
+     *
+     * Calculate liquidity issued for a balanced deposit of {quantity0} & {quantity1} into already loaded {pair} row
+     * Deposits keep the reserves ratio, the remaining quantity is refunded as excess (see `deposit`)
+     *
+     * ### params
+     *
+     * - `{pairs_row} pair` - pair
+     * - `{asset} quantity0` - deposit quantity of reserve0
+     * - `{asset} quantity1` - deposit quantity of reserve1
+     *
+     * ### returns
+     *
+     * - `{deposit_result}` - issued liquidity, deposited & refunded quantities
+     */
+    static deposit_result get_deposit_out( const pairs_row& pair, const asset quantity0, const asset quantity1 )
+    {
+        const symbol sym0 = pair.reserve0.quantity.symbol;
+        const symbol sym1 = pair.reserve1.quantity.symbol;
+        check( quantity0.symbol == sym0 && quantity1.symbol == sym1, "curve.sx::get_deposit_out: invalid deposit symbols");
+        check( quantity0.amount > 0 && quantity1.amount > 0, "curve.sx::get_deposit_out: one of the deposit is empty");
 
-    [[eosio::action]]
-    void stopramp( const symbol_code pair_id );
+        // calculate total deposits based on reserves: reserves ratio should remain the same
+        // if reserves empty, fallback to 1
+        const int64_t scale0 = pair.get_scale0();
+        const int64_t scale1 = pair.get_scale1();
+        const int128_t reserve0 = pair.reserve0.quantity.amount ? pair.get_reserve0() : 1;
+        const int128_t reserve1 = pair.reserve1.quantity.amount ? pair.get_reserve1() : 1;
+        const int128_t reserves = reserve0 + reserve1;
 
-    [[eosio::action]]
-    void liquiditylog( const symbol_code pair_id, const name owner, const name action, const asset liquidity, const asset quantity0, const asset quantity1, const asset total_liquidity, const asset reserve0, const asset reserve1 );
+        // normalize deposits & calculate payment
+        const int128_t amount0 = mul_scale( quantity0.amount, scale0 );
+        const int128_t amount1 = mul_scale( quantity1.amount, scale1 );
+        const int128_t payment = amount0 + amount1;
 
-    [[eosio::action]]
-    void swaplog( const symbol_code pair_id, const name owner, const name action, const asset quantity_in, const asset quantity_out, const asset fee, const double trade_price, const asset reserve0, const asset reserve1 );
+        // calculate actual amounts to deposit
+        const int128_t deposit0 = (amount0 * reserves <= reserve0 * payment) ? amount0 : (amount1 * reserve0 / reserve1);
+        const int128_t deposit1 = (amount0 * reserves <= reserve0 * payment) ? (amount0 * reserve1 / reserve0) : amount1;
 
-    [[eosio::action]]
-    void calculate( const uint64_t amount, const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t amplifier, const uint64_t fee );
+        // issue liquidity
+        const int64_t issued = rex::issue( deposit0 + deposit1, reserves, pair.get_supply(), 1 );
 
-    using deposit_action = eosio::action_wrapper<"deposit"_n, &sx::curve::deposit>;
-    using cancel_action = eosio::action_wrapper<"cancel"_n, &sx::curve::cancel>;
-    using createpair_action = eosio::action_wrapper<"createpair"_n, &sx::curve::createpair>;
-    using removepair_action = eosio::action_wrapper<"removepair"_n, &sx::curve::removepair>;
-    using setfee_action = eosio::action_wrapper<"setfee"_n, &sx::curve::setfee>;
-    using setstatus_action = eosio::action_wrapper<"setstatus"_n, &sx::curve::setstatus>;
-    using ramp_action = eosio::action_wrapper<"ramp"_n, &sx::curve::ramp>;
-    using stopramp_action = eosio::action_wrapper<"stopramp"_n, &sx::curve::stopramp>;
-    using liquiditylog_action = eosio::action_wrapper<"liquiditylog"_n, &sx::curve::liquiditylog>;
-    using swaplog_action = eosio::action_wrapper<"swaplog"_n, &sx::curve::swaplog>;
-    using calculate_action = eosio::action_wrapper<"calculate"_n, &sx::curve::calculate>;
+        return {
+            { issued / pair.get_scale_lp(), pair.liquidity.quantity.symbol },
+            { static_cast<int64_t>(deposit0 / scale0), sym0 },
+            { static_cast<int64_t>(deposit1 / scale1), sym1 },
+            { static_cast<int64_t>(amount0 - deposit0) / scale0, sym0 },
+            { static_cast<int64_t>(amount1 - deposit1) / scale1, sym1 }
+        };
+    }
 
     /**
-     * ## STATIC `get_amplifier`
+     * ## STATIC `get_withdraw_out`
      *
-     * Retrieve current amplifier for pair
+     * Calculate reserves paid out for withdrawing {liquidity} from its pair (same calculation as withdraw transfers)
      *
      * ### params
      *
-     * - `{symbol_code} pair_id` - pair id
+     * - `{asset} liquidity` - liquidity token quantity (symbol code is the pair id)
      *
      * ### returns
      *
-     * - `{asset}` - calculated return
+     * - `{withdraw_result}` - reserve0 & reserve1 quantities paid out
      *
      * ### example
      *
      * ```c++
-     * const symbol_code pair_id = symbol_code {"SXA"};
-     * const uint64_t amplifier  = sx::curve::get_amplifier( pair_id );
-     * //=> 100
+     * const auto result = sx::curve::get_withdraw_out( asset{20'0000, {"SXA", 4}} );
+     * //=> { "out0": "10.0000 USDT", "out1": "10.0000 USN" }
      * ```
      */
-    static uint64_t get_amplifier( const symbol_code pair_id )
+    static withdraw_result get_withdraw_out( const asset liquidity )
     {
-        sx::curve::ramp_table _ramp( sx::curve::code, sx::curve::code.value );
         sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        const auto& pair = _pairs.get( liquidity.symbol.code().raw(), "curve.sx::get_withdraw_out: invalid pair id" );
 
-        auto pairs = _pairs.get( pair_id.raw(), "curve.sx::get_amplifier: invalid `pair_id`" );
-        auto ramp = _ramp.find( pair_id.raw() );
-
-        // if no ramp exists, use pair's amplifier
-        if ( ramp == _ramp.end() ) return pairs.amplifier;
+        return get_withdraw_out( pair, liquidity );
+    }
 
-        const uint32_t now = current_time_point().sec_since_epoch();
-        const uint32_t t1 = ramp->end_time.sec_since_epoch();
-        const uint64_t A1 = ramp->target_amplifier;
+    /**
+     * ## STATIC `get_withdraw_out`
+     *
+     * Calculate reserves paid out for withdrawing {liquidity} from already loaded {pair} row, proportional to reserves
+     *
+     * ### params
+     *
+     * - `{pairs_row} pair` - pair
+     * - `{asset} liquidity` - liquidity token quantity
+     *
+     * ### returns
+     *
+     * - `{withdraw_result}` - reserve0 & reserve1 quantities paid out
+     */
+    static withdraw_result get_withdraw_out( const pairs_row& pair, const asset liquidity )
+    {
+        check( pair.liquidity.quantity.symbol == liquidity.symbol, "curve.sx::get_withdraw_out: invalid liquidity symbol");
+        check( liquidity.amount > 0 && liquidity.amount <= pair.liquidity.quantity.amount, "curve.sx::get_withdraw_out: invalid liquidity amount");
 
-        // ramping up or down amplifier
-        if ( now < t1 ) {
-            const uint64_t A0 = ramp->start_amplifier;
-            const uint32_t t0 = ramp->start_time.sec_since_epoch();
+        // calculate total deposits based on reserves
+        const int64_t supply = pair.get_supply();
+        const int128_t reserve0 = pair.reserve0.quantity.amount ? pair.get_reserve0() : 1;
+        const int128_t reserve1 = pair.reserve1.quantity.amount ? pair.get_reserve1() : 1;
+        const int128_t reserves = reserve0 + reserve1;
 
-            // ramp down if future amplifier is smaller than initial amplifier
-            if ( A1 > A0 ) return A0 + (A1 - A0) * (now - t0) / (t1 - t0);
-            else return A0 - (A0 - A1) * (now - t0) / (t1 - t0);
+        // calculate withdraw amounts
+        const int64_t payment = mul_scale( liquidity.amount, pair.get_scale_lp() );
+        const int64_t retire_amount = rex::retire( payment, reserves, supply );
 
-        // ramp up has reached maximum limit
-        } else return A1;
+        int64_t amount0 = static_cast<int64_t>( retire_amount * reserve0 / reserves );
+        int64_t amount1 = static_cast<int64_t>( retire_amount * reserve1 / reserves );
+        if (amount0 == reserve0 || amount1 == reserve1) {         //deal with rounding error on final withdrawal
+            amount0 = static_cast<int64_t>( reserve0 );
+            amount1 = static_cast<int64_t>( reserve1 );
+        }
+        const withdraw_result result = {
+            { amount0 / pair.get_scale0(), pair.reserve0.quantity.symbol },
+            { amount1 / pair.get_scale1(), pair.reserve1.quantity.symbol }
+        };
+        check( result.out0.amount || result.out1.amount, "curve.sx::get_withdraw_out: withdraw amount too small");
+        return result;
     }
 
     /**
-     * ## STATIC `get_amount_out`
+     * ## STATIC `get_pool_amount_out`
      *
-     * Calculate return for converting {in} amount via {pair_id} pool
+     * Calculate return for converting {in} amount into {symcode_out} reserve via {pool_id} pool
      *
      * ### params
      *
      * - `{asset} in` - input token quantity
-     * - `{symbol_code} pair_id` - pair id
+     * - `{symbol_code} pool_id` - pool id
+     * - `{symbol_code} symcode_out` - output reserve symbol code
      *
      * ### returns
      *
@@ -315,56 +1919,224 @@ public:
      *
      * ```c++
      * const asset in = asset{10'0000, {"A", 4}};
-     * const symbol_code pair_id = symbol_code{"SXA"};
+     * const symbol_code pool_id = symbol_code{"ABC"};
      *
-     * const asset out = sx::curve::get_amount_out( in, pair_id );
-     * //=> "10.1000 B"
+     * const asset out = sx::curve::get_pool_amount_out( in, pool_id, symbol_code{"C"} );
+     * //=> "9.995901234 C"
      * ```
      */
-    static asset get_amount_out( const asset in, const symbol_code pair_id )
+    static asset get_pool_amount_out( const asset in, const symbol_code pool_id, const symbol_code symcode_out )
     {
         sx::curve::config_table _config( sx::curve::code, sx::curve::code.value );
-        sx::curve::pairs_table _pairs( sx::curve::code, sx::curve::code.value );
+        sx::curve::pools_table _pools( sx::curve::code, sx::curve::code.value );
         check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
 
         // get configs
-        auto config = _config.get();
-        auto pairs = _pairs.get( pair_id.raw(), "curve.sx::get_amount_out: invalid pair id" );
+        const auto config = _config.get();
+        const auto& pool = _pools.get( pool_id.raw(), "curve.sx::get_pool_amount_out: invalid pool id" );
 
-        // inverse reserves based on input quantity
-        if (pairs.reserve0.quantity.symbol != in.symbol) std::swap(pairs.reserve0, pairs.reserve1);
-        eosio::check( pairs.reserve0.quantity.symbol == in.symbol, "curve.sx::get_amount_out: no such reserve in pairs");
+        return get_pool_amount_out( in, pool, config, symcode_out );
+    }
+
+    /**
+     * ## STATIC `get_pool_amount_out`
+     *
+     * Calculate return for converting {in} amount into {symcode_out} reserve via already loaded {pool} row & {config}
+     *
+     * ### params
+     *
+     * - `{asset} in` - input token quantity
+     * - `{pools_row} pool` - pool
+     * - `{config_row} config` - config
+     * - `{symbol_code} symcode_out` - output reserve symbol code
+     *
+     * ### returns
+     *
+     * - `{asset}` - calculated return
+     */
+    static asset get_pool_amount_out( const asset in, const pools_row& pool, const config_row& config, const symbol_code symcode_out )
+    {
+        const size_t i = get_pool_index( pool, in.symbol.code() );
+        const size_t j = get_pool_index( pool, symcode_out );
+        check( i != j, "curve.sx::get_pool_amount_out: input and output reserves must be different");
 
         // normalize inputs to max precision
-        const uint8_t precision_in = pairs.reserve0.quantity.symbol.precision();
-        const uint8_t precision_out = pairs.reserve1.quantity.symbol.precision();
+        const uint8_t precision_in = pool.reserves[i].quantity.symbol.precision();
+        const uint8_t precision_out = pool.reserves[j].quantity.symbol.precision();
+        check( pool.reserves[i].quantity.symbol == in.symbol, "curve.sx::get_pool_amount_out: no such reserve in pool");
         const int64_t amount_in = mul_amount( in.amount, MAX_PRECISION, precision_in );
-        const int64_t reserve_in = mul_amount( pairs.reserve0.quantity.amount, MAX_PRECISION, precision_in );
-        const int64_t reserve_out = mul_amount( pairs.reserve1.quantity.amount, MAX_PRECISION, precision_out );
-        const uint64_t amplifier = get_amplifier( pair_id );
+        const vector<uint64_t> reserves = get_pool_reserves( pool );
         const int64_t protocol_fee = amount_in * config.protocol_fee / 10000;
 
+        // cached invariant is exact if computed with current amplifier
+        const uint64_t D_hint = pool.invariant_amplifier == pool.amplifier ? pool.invariant : 0;
+
         // enforce minimum fee
-        if ( config.trade_fee ) check( in.amount * config.trade_fee / 10000, "curve.sx::get_amount_out: trade quantity too small");
+        if ( config.trade_fee ) check( in.amount * config.trade_fee / 10000, "curve.sx::get_pool_amount_out: trade quantity too small");
 
-        // calculate out
-        const int64_t out = div_amount( static_cast<int64_t>(Curve::get_amount_out( amount_in - protocol_fee, reserve_in, reserve_out, amplifier, config.trade_fee )), MAX_PRECISION, precision_out );
+        // calculate out (dispatch to compile-time coin count)
+        uint64_t out = 0;
+        switch ( reserves.size() ) {
+            case 3: out = Curve::get_amount_out<3>( amount_in - protocol_fee, i, j, to_array<3>( reserves ), pool.amplifier, config.trade_fee, D_hint ); break;
+            case 4: out = Curve::get_amount_out<4>( amount_in - protocol_fee, i, j, to_array<4>( reserves ), pool.amplifier, config.trade_fee, D_hint ); break;
+            default: check( false, "curve.sx::get_pool_amount_out: invalid pool reserves" );
+        }
+        return { div_amount( static_cast<int64_t>(out), MAX_PRECISION, precision_out ), pool.reserves[j].quantity.symbol };
+    }
 
-        return { out, pairs.reserve1.quantity.symbol };
+    /**
+     * ## STATIC `get_pool_invariant`
+     *
+     * Calculate StableSwap invariant D of pool reserves (normalized to `MAX_PRECISION`)
+     * Newton iteration is warm-started from the pool's cached `invariant`
+     *
+     * ### params
+     *
+     * - `{pools_row} pool` - pool
+     * - `{uint64_t} amplifier` - amplifier
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - invariant D (0 if any reserve is empty)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t invariant = sx::curve::get_pool_invariant( pool, amplifier );
+     * //=> 3000000000000
+     * ```
+     */
+    static uint64_t get_pool_invariant( const pools_row& pool, const uint64_t amplifier )
+    {
+        for ( const extended_asset& reserve : pool.reserves ) {
+            if ( !reserve.quantity.amount ) return 0;
+        }
+        const vector<uint64_t> reserves = get_pool_reserves( pool );
+        switch ( reserves.size() ) {
+            case 3: return Curve::get_invariant<3>( to_array<3>( reserves ), amplifier, pool.invariant );
+            case 4: return Curve::get_invariant<4>( to_array<4>( reserves ), amplifier, pool.invariant );
+        }
+        check( false, "curve.sx::get_pool_invariant: invalid pool reserves" );
+        return 0;
     }
 
-    static int64_t mul_amount( const int64_t amount, const uint8_t precision0, const uint8_t precision1 )
+    // index of reserve {symcode} in pool reserves
+    static size_t get_pool_index( const pools_row& pool, const symbol_code symcode )
+    {
+        for ( size_t i = 0; i < pool.reserves.size(); ++i ) {
+            if ( pool.reserves[i].quantity.symbol.code() == symcode ) return i;
+        }
+        check( false, "curve.sx::get_pool_index: no such reserve in pool" );
+        return 0;
+    }
+
+    // pool reserves normalized to max precision
+    static vector<uint64_t> get_pool_reserves( const pools_row& pool )
     {
-        check(precision0 >= precision1, "curve.sx::mul_amount: invalid precisions");
-        const int64_t res = static_cast<int64_t>( safemath::mul(amount, pow(10, precision0 - precision1 )) );
-        check(res >= 0, "curve.sx::mul_amount: mul overflow");
+        vector<uint64_t> reserves;
+        reserves.reserve( pool.reserves.size() );
+        for ( const extended_asset& reserve : pool.reserves ) {
+            reserves.push_back( mul_amount( reserve.quantity.amount, MAX_PRECISION, reserve.quantity.symbol.precision() ) );
+        }
+        return reserves;
+    }
+
+    template <size_t N>
+    static std::array<uint64_t, N> to_array( const vector<uint64_t>& values )
+    {
+        std::array<uint64_t, N> result;
+        for ( size_t i = 0; i < N; ++i ) result[i] = values[i];
+        return result;
+    }
+
+    /**
+     * ## STATIC `get_token_key`
+     *
+     * Unique 128-bit key of extended symbol (contract & symbol)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint128_t key = sx::curve::get_token_key( extended_symbol{ {"A", 4}, "eosio.token"_n } );
+     * ```
+     */
+    static uint128_t get_token_key( const extended_symbol ext_sym )
+    {
+        return ( uint128_t{ ext_sym.get_contract().value } << 64 ) | ext_sym.get_symbol().raw();
+    }
+
+    /**
+     * ## STATIC `get_pair_key`
+     *
+     * Unique 256-bit key of unordered extended symbols pair (see `get_token_key`), same key for {token0, token1} & {token1, token0}
+     *
+     * ### example
+     *
+     * ```c++
+     * const checksum256 key = sx::curve::get_pair_key( extended_symbol{ {"A", 4}, "eosio.token"_n }, extended_symbol{ {"B", 4}, "eosio.token"_n } );
+     * ```
+     */
+    static checksum256 get_pair_key( const extended_symbol token0, const extended_symbol token1 )
+    {
+        const uint128_t key0 = get_token_key( token0 );
+        const uint128_t key1 = get_token_key( token1 );
+        return checksum256( std::array<uint128_t, 2>{ std::min( key0, key1 ), std::max( key0, key1 ) } );
+    }
+
+    /**
+     * ## STATIC `get_scale`
+     *
+     * Scale factor normalizing {precision} to `MAX_PRECISION` (`POW10` table lookup)
+     *
+     * ### example
+     *
+     * ```c++
+     * const int64_t scale = sx::curve::get_scale( 4 );
+     * //=> 100000
+     * ```
+     */
+    static int64_t get_scale( const uint8_t precision )
+    {
+        check(precision <= MAX_PRECISION, "curve.sx::get_scale: invalid precision");
+        return POW10[ MAX_PRECISION - precision ];
+    }
+
+    /**
+     * ## STATIC `to_fixed_price`
+     *
+     * Convert legacy floating point price to fixed point (scaled by `Curve::PRICE_SCALE`, 0 if not positive, saturated)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t price = sx::curve::to_fixed_price( 1.0002 );
+     * //=> 1000200000
+     * ```
+     */
+    static uint64_t to_fixed_price( const double price )
+    {
+        if ( !( price > 0 ) ) return 0;
+        const double scaled = price * Curve::PRICE_SCALE;
+        return scaled >= static_cast<double>( UINT64_MAX ) ? UINT64_MAX : static_cast<uint64_t>( scaled );
+    }
+
+    static int64_t mul_scale( const int64_t amount, const int64_t scale )
+    {
+        const int64_t res = static_cast<int64_t>( safemath::mul(amount, scale) );
+        check(res >= 0, "curve.sx::mul_scale: mul overflow");
         return res;
     }
 
+    static int64_t mul_amount( const int64_t amount, const uint8_t precision0, const uint8_t precision1 )
+    {
+        check(precision0 >= precision1 && precision0 - precision1 <= MAX_PRECISION, "curve.sx::mul_amount: invalid precisions");
+        return mul_scale( amount, POW10[ precision0 - precision1 ] );
+    }
+
     static int64_t div_amount( const int64_t amount, const uint8_t precision0, const uint8_t precision1 )
     {
-        check(precision0 >= precision1, "curve.sx::div_amount: invalid precisions");
-        return amount / static_cast<int64_t>(pow( 10, precision0 - precision1 ));
+        check(precision0 >= precision1 && precision0 - precision1 <= MAX_PRECISION, "curve.sx::div_amount: invalid precisions");
+        return amount / POW10[ precision0 - precision1 ];
     }
 
 private:
@@ -376,17 +2148,63 @@ private:
 
     // swap conversions
     void convert( const name owner, const extended_asset ext_in, const vector<symbol_code> pair_ids, const int64_t min_return );
-    extended_asset apply_trade( const name owner, const extended_asset ext_quantity, const vector<symbol_code> pair_ids );
+    void convert_out( const name owner, const extended_asset ext_in, const vector<symbol_code> pair_ids, const int64_t amount_out, const int64_t max_in );
+    extended_asset apply_trade( const name owner, const extended_asset ext_quantity, const vector<symbol_code> pair_ids, const config_row& config );
+    extended_asset apply_trade( const extended_asset ext_quantity, const vector<symbol_code> pair_ids, const config_row& config, vector<trade_record>& trades );
+    void convert_split( const name owner, const extended_asset ext_in, const vector<vector<symbol_code>> legs, const vector<uint64_t> weights, const int64_t min_return );
+    void convert_pool( const name owner, const extended_asset ext_in, const symbol_code pool_id, const symbol_code symcode_out, const int64_t min_return );
+
+    // swap routes
+    vector<symbol_code> find_route( const extended_asset ext_in, const symbol_code symcode_out );
+    void search_routes( const extended_asset ext_in, const symbol_code symcode_out, const config_row& config, pairs_table& _pairs, vector<symbol_code>& path, vector<symbol_code>& best_path, int64_t& best_out, uint8_t& quotes );
+    vector<int64_t> get_split_amounts( const extended_asset ext_in, const vector<vector<symbol_code>> legs, const config_row& config, pairs_table& _pairs );
 
     // add/remove liquidity
     void add_liquidity( const name owner, const symbol_code pair_id, const extended_asset value );
     void withdraw_liquidity( const name owner, const extended_asset value );
+    void add_liquidity_instant( const name owner, const symbol_code pair_id, const extended_asset value, const int64_t min_return );
+    void withdraw_liquidity_one( const name owner, const extended_asset value, const symbol_code symcode_out, const int64_t min_return );
+
+    // add/remove pool liquidity
+    void add_pool_liquidity( const name owner, const symbol_code pool_id, const extended_asset value );
+    void deposit_pool( const name owner, const symbol_code pool_id );
+    void cancel_pool( const name owner, const symbol_code pool_id );
+    void withdraw_pool_liquidity( const name owner, const extended_asset value );
+
+    // deposit orders & balances
+    void refund_order( const name owner, const symbol_code pair_id, const string memo );
+    void credit_order( const name owner, const symbol_code pair_id );
+    void add_order_index( const name owner, const symbol_code pair_id );
+    void remove_order_index( const name owner, const symbol_code pair_id );
+    void add_balance( const name owner, const extended_asset value );
+
+    // protocol fees
+    void accrue_fee( const extended_asset fee );
+
+    // pair state
+    void update_amplifier( pairs_row& row, const uint64_t amplifier );
+    void update_oracle( pairs_row& row, const uint64_t amplifier );
+
+    // upgrades (see `migrate`)
+    void upgrade_pair( pairs_row& row );
+    void upgrade_config( config_row& config );
+
+    // observations
+    void update_observation( const pairs_row& pair, const uint32_t interval );
+    void erase_observations( const symbol_code pair_id );
 
     // utils
-    memo_schema parse_memo( const string memo );
-    vector<symbol_code> parse_memo_pair_ids( const string memo );
-    double calculate_price( const asset value0, const asset value1 );
-    double calculate_virtual_price( const asset value0, const asset value1, const asset supply );
+    memo_schema parse_memo( const string& memo );
+    vector<symbol_code> parse_memo_pair_ids( const string_view memo );
+    static uint64_t calculate_price( const asset value0, const asset value1 );
+    uint64_t calculate_virtual_price( const pairs_row& pair );
+    uint64_t calculate_pool_virtual_price( const vector<extended_asset>& reserves, const asset supply );
+
+    // fixed-point price as floating point (read-only helpers)
+    static double to_price( const uint64_t value )
+    {
+        return static_cast<double>( value ) / Curve::PRICE_SCALE;
+    }
 };
 
 } // namespace sx
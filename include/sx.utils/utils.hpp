@@ -2,6 +2,8 @@
 
 #include <eosio/asset.hpp>
 #include <math.h>
+#include <array>
+#include <string_view>
 
 namespace sx {
 namespace utils {
@@ -14,6 +16,7 @@ namespace utils {
     using eosio::symbol_code;
 
     using std::string;
+    using std::string_view;
     using std::vector;
 
     /**
@@ -144,6 +147,81 @@ namespace utils {
         return tokens;
     }
 
+    /**
+     * ## STATIC `next_token`
+     *
+     * Read next token of {str} starting at {pos} without heap allocation (empty tokens are skipped like `split`)
+     *
+     * ### params
+     *
+     * - `{string_view} str` - string to tokenize
+     * - `{char} delim` - delimiter (ex: ',')
+     * - `{size_t&} pos` - read position, advanced past the returned token
+     * - `{string_view&} token` - token (view into {str})
+     *
+     * ### returns
+     *
+     * - `{bool}` - false if no token remains
+     *
+     * ### example
+     *
+     * ```c++
+     * size_t pos = 0;
+     * string_view token;
+     * while ( sx::utils::next_token( "SXA-SXB", '-', pos, token ) ) {
+     *     // token => "SXA", "SXB"
+     * }
+     * ```
+     */
+    static bool next_token( const string_view str, const char delim, size_t& pos, string_view& token )
+    {
+        while ( pos < str.size() ) {
+            size_t end = str.find( delim, pos );
+            if ( end == string_view::npos ) end = str.size();
+            token = str.substr( pos, end - pos );
+            pos = end + 1;
+            if ( token.size() ) return true;
+        }
+        return false;
+    }
+
+    /**
+     * ## STATIC `split_view`
+     *
+     * Split string into at most N tokens without heap allocation (tokens are views into {str})
+     *
+     * ### params
+     *
+     * - `{string_view} str` - string to split
+     * - `{char} delim` - delimiter (ex: ',')
+     * - `{array<string_view, N>&} tokens` - tokenized strings
+     *
+     * ### returns
+     *
+     * - `{size_t}` - number of tokens (N + 1 if {str} has more than N tokens)
+     *
+     * ### example
+     *
+     * ```c++
+     * std::array<string_view, 4> tokens;
+     * const size_t size = sx::utils::split_view( "swap,0,SXA", ',', tokens );
+     * // size => 3
+     * // tokens[2] => "SXA"
+     * ```
+     */
+    template <size_t N>
+    static size_t split_view( const string_view str, const char delim, std::array<string_view, N>& tokens )
+    {
+        size_t size = 0;
+        size_t pos = 0;
+        string_view token;
+        while ( next_token( str, delim, pos, token ) ) {
+            if ( size == N ) return N + 1;
+            tokens[size++] = token;
+        }
+        return size;
+    }
+
     /**
      * ## STATIC `parse_name`
      *
@@ -151,7 +229,7 @@ namespace utils {
      *
      * ### params
      *
-     * - `{string} str` - string to parse
+     * - `{string_view} str` - string to parse
      *
      * ### returns
      *
@@ -164,7 +242,7 @@ namespace utils {
      * // contract => "tethertether"_n
      * ```
      */
-    static name parse_name(const string& str) {
+    static name parse_name(const string_view str) {
 
         if(str.length()==0 || str.length()>13) return {};
         int i=-1;
@@ -185,7 +263,7 @@ namespace utils {
      *
      * ### params
      *
-     * - `{string} str` - string to parse
+     * - `{string_view} str` - string to parse
      *
      * ### returns
      *
@@ -198,7 +276,7 @@ namespace utils {
      * // symcode => symbol_code{"USDT"}
      * ```
      */
-    static symbol_code parse_symbol_code(const string& str) {
+    static symbol_code parse_symbol_code(const string_view str) {
         for (const auto c: str ) {
             if( !isalpha(c) || islower(c)) return {};
         }
@@ -369,6 +447,38 @@ namespace utils {
         return extended_asset {quantity, contract};
     }
 
+    /**
+     * ## STATIC `parse_amount`
+     *
+     * Parse unsigned decimal string for amount without heap allocation. Return -1 if invalid (empty, non-digit or overflow).
+     *
+     * ### params
+     *
+     * - `{string_view} str` - string to parse
+     *
+     * ### returns
+     *
+     * - `{int64_t}` - amount
+     *
+     * ### example
+     *
+     * ```c++
+     * const int64_t amount = sx::utils::parse_amount( "10000" );
+     * // amount => 10000
+     * ```
+     */
+    static int64_t parse_amount( const string_view str )
+    {
+        if ( !str.size() ) return -1;
+        int64_t amount = 0;
+        for ( const auto c: str ) {
+            if ( !isdigit(c) ) return -1;
+            if ( amount > ( INT64_MAX - (c - '0') ) / 10 ) return -1;
+            amount = amount * 10 + (c - '0');
+        }
+        return amount;
+    }
+
     /**
      * ## STATIC `is_digit`
      *
@@ -376,7 +486,7 @@ namespace utils {
      *
      * ### params
      *
-     * - `{string} str` - string to parse
+     * - `{string_view} str` - string to parse
      *
      * ### returns
      *
@@ -392,7 +502,7 @@ namespace utils {
      * // => false
      * ```
      */
-    bool is_digit( const string str )
+    bool is_digit( const string_view str )
     {
         if ( !str.size() ) return false;
         for ( const auto c: str ) {
@@ -408,7 +518,7 @@ namespace utils {
      *
      * ### params
      *
-     * - `{string} str` - string to parse
+     * - `{string_view} str` - string to parse
      *
      * ### returns
      *
@@ -424,7 +534,7 @@ namespace utils {
      * // => false
      * ```
      */
-    bool is_alpha( const string str )
+    bool is_alpha( const string_view str )
     {
         if ( !str.size() ) return false;
         for ( const auto c: str ) {
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# native (host) build of the Curve math kernel & memo parser
+# warnings are errors (header-only `static` helpers are unused by design)
+FLAGS="-std=c++17 -O2 -Wall -Wextra -Werror -Wno-unused-function"
+mkdir -p build
+g++ $FLAGS -I bench/include -I include -I . bench/curve.bench.cpp -o build/curve.bench
+g++ $FLAGS -I bench/include -I include -I . bench/memo.bench.cpp -o build/memo.bench
+
+# run benchmarks
+./build/curve.bench "$@"
+./build/memo.bench "$@"
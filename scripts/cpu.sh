@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# CPU usage (us) of 1, 2 & 3 hop swaps on local nodeos
+#
+# requires deployed contract with liquidity in AB, BC & AC pairs (ex: `./test.sh` up to `liquidity.bats`)
+# run once per deployed build (ex: before & after a change) and compare the tables
+#
+# $ ./scripts/cpu.sh [iterations]
+
+ITERATIONS=${1:-20}
+ROUTES=("AB" "AB-BC" "AB-BC-AC")
+
+# unlock wallet
+cleos wallet unlock --password $(cat ~/eosio-wallet/.pass) > /dev/null 2>&1
+
+printf "%5s %-10s %8s %8s %8s %8s\n" "hops" "route" "samples" "min" "median" "avg"
+for route in "${ROUTES[@]}"; do
+  hops=$(( $(echo "$route" | tr -cd '-' | wc -c) + 1 ))
+  samples=()
+  for i in $(seq 1 $ITERATIONS); do
+    # unique quantity per transaction to avoid duplicate transactions
+    cpu=$(cleos transfer myaccount curve.sx "1.$(printf %04d $i) A" "swap,0,$route" --json 2> /dev/null | jq -r '.processed.receipt.cpu_usage_us')
+    if [ -n "$cpu" ] && [ "$cpu" != "null" ]; then samples+=($cpu); fi
+  done
+  printf "%s\n" "${samples[@]}" | sort -n | awk -v hops=$hops -v route=$route '
+    { v[NR] = $1; sum += $1 }
+    END {
+      if ( NR == 0 ) { printf "%5d %-10s %8d %8s %8s %8s\n", hops, route, 0, "-", "-", "-"; exit }
+      printf "%5d %-10s %8d %8d %8d %8.1f\n", hops, route, NR, v[1], v[int((NR + 1) / 2)], sum / NR
+    }'
+done
@@ -0,0 +1,22 @@
+#!/bin/bash
+# creates pairs in legacy layout (no extensions & no secondary indices) with the pre-upgrade contract
+# usage: ./scripts/legacy.sh '<createpair args>' ...
+
+# unlock wallet
+cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
+
+# build pre-upgrade contract (first release by default)
+LEGACY_REF=${LEGACY_REF:-$(git rev-list --max-parents=0 HEAD)}
+rm -rf build/legacy && mkdir -p build/legacy
+git archive $LEGACY_REF | tar -x -C build/legacy
+(cd build/legacy && eosio-cpp curve.sx.cpp -I include) || exit 1
+
+# create pairs with pre-upgrade contract
+cleos set contract curve.sx build/legacy curve.sx.wasm curve.sx.abi || exit 1
+for args in "$@"; do
+    cleos push action curve.sx createpair "$args" -p curve.sx || status=1
+done
+
+# restore current contract
+cleos set contract curve.sx . curve.sx.wasm curve.sx.abi || exit 1
+exit ${status:-0}
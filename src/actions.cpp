@@ -1,18 +1,33 @@
 namespace sx {
 
 [[eosio::action]]
-void curve::liquiditylog( const symbol_code pair_id, const name owner, const name action, const asset liquidity, const asset quantity0,  const asset quantity1, const asset total_liquidity, const asset reserve0, const asset reserve1 )
+void curve::liquiditylog( const symbol_code pair_id, const name owner, const name action, const asset liquidity, const asset quantity0,  const asset quantity1, const asset total_liquidity, const asset reserve0, const asset reserve1, const name stats_account )
 {
     require_auth( get_self() );
-    if ( is_account( "stats.sx"_n ) ) require_recipient( "stats.sx"_n );
+    if ( stats_account.value ) require_recipient( stats_account );
     require_recipient( owner );
 }
 
+// deprecated (replaced by `tradelog`), kept as no-op for one release
 [[eosio::action]]
 void curve::swaplog( const symbol_code pair_id, const name owner, const name action, const asset quantity_in, const asset quantity_out, const asset fee, const double trade_price, const asset reserve0, const asset reserve1 )
 {
     require_auth( get_self() );
-    if ( is_account( "stats.sx"_n ) ) require_recipient( "stats.sx"_n );
+}
+
+[[eosio::action]]
+void curve::tradelog( const name owner, const name action, const vector<trade_record> trades, const name stats_account )
+{
+    require_auth( get_self() );
+    if ( stats_account.value ) require_recipient( stats_account );
+    require_recipient( owner );
+}
+
+[[eosio::action]]
+void curve::poollog( const symbol_code pool_id, const name owner, const name action, const asset liquidity, const vector<asset> quantities, const asset total_liquidity, const vector<asset> reserves, const name stats_account )
+{
+    require_auth( get_self() );
+    if ( stats_account.value ) require_recipient( stats_account );
     require_recipient( owner );
 }
 
@@ -0,0 +1,151 @@
+namespace sx {
+
+// execute `orders` against deposited balances (see "batch" memo)
+// config & pair rows are loaded once, orders are applied sequentially on in-memory rows,
+// touched pairs are written once & remaining balances are settled with one transfer per token
+[[eosio::action]]
+void curve::batchswap( const name owner, const vector<batch_order> orders )
+{
+    require_auth( owner );
+
+    curve::config_table _config( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::balances_table _balances( get_self(), owner.value );
+    check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+    const auto config = _config.get();
+    check( (config.status == "ok"_n || config.status == "testing"_n), "curve.sx::batchswap: contract is under maintenance");
+
+    // deposited balances
+    vector<extended_asset> balances;
+    for ( const auto& row : _balances ) balances.push_back( row.balance );
+    check( balances.size(), "curve.sx::batchswap: no deposited balance");
+
+    auto balance_of = [&]( const extended_symbol ext_sym ) -> extended_asset& {
+        for ( extended_asset& balance : balances ) {
+            if ( balance.get_extended_symbol() == ext_sym ) return balance;
+        }
+        balances.push_back( { 0, ext_sym } );
+        return balances.back();
+    };
+
+    // already loaded pair rows & current amplifiers (written once after all orders)
+    map<symbol_code, pair<pairs_row, uint64_t>> loaded;
+    vector<extended_asset> fees;
+    vector<trade_record> trades;
+
+    for ( const batch_order& order : orders ) {
+        check( order.pair_ids.size() >= 1, "curve.sx::batchswap: `pair_ids` cannot be empty");
+        check( order.in.quantity.amount > 0, "curve.sx::batchswap: invalid order quantity");
+
+        // spend input from deposited balance
+        extended_asset& balance = balance_of( order.in.get_extended_symbol() );
+        check( balance.quantity.amount >= order.in.quantity.amount, "curve.sx::batchswap: insufficient balance");
+        balance -= order.in;
+
+        extended_asset ext_in = order.in;
+        for ( const symbol_code pair_id : order.pair_ids ) {
+            auto itr = loaded.find( pair_id );
+            if ( itr == loaded.end() ) {
+                const auto& row = _pairs.get( pair_id.raw(), "curve.sx::batchswap: `pair_id` does not exist");
+                itr = loaded.emplace( pair_id, std::make_pair( row, get_amplifier( row ) ) ).first;
+            }
+            pairs_row& pairs = itr->second.first;
+            const uint64_t amplifier = itr->second.second;
+            const bool is_in = pairs.reserve0.get_extended_symbol() == ext_in.get_extended_symbol();
+            const extended_asset reserve_in = is_in ? pairs.reserve0 : pairs.reserve1;
+            const extended_asset reserve_out = is_in ? pairs.reserve1 : pairs.reserve0;
+
+            // validate input quantity & reserves
+            check(reserve_in.get_extended_symbol() == ext_in.get_extended_symbol(), "curve.sx::batchswap: incoming currency/reserves contract mismatch");
+            check(reserve_in.quantity.amount != 0 && reserve_out.quantity.amount != 0, "curve.sx::batchswap: empty pool reserves");
+
+            // calculate out (same calculation as `apply_trade`)
+            const trade_record trade = get_trade( ext_in.quantity, pairs, config, amplifier );
+            const extended_asset protocol_fee = { ext_in.quantity.amount * config.protocol_fee / 10000, ext_in.get_extended_symbol() };
+
+            // modify in-memory reserves (cached invariant is recalculated when written)
+            pairs.reserve0.quantity = trade.reserve0;
+            pairs.reserve1.quantity = trade.reserve1;
+            if ( is_in ) pairs.volume0 += ext_in.quantity;
+            else pairs.volume1 += ext_in.quantity;
+            const uint64_t price_inverse = calculate_price( trade.quantity_out, trade.quantity_in );
+            pairs.prices.emplace( price_params{ 0, is_in ? price_inverse : trade.trade_price, is_in ? trade.trade_price : price_inverse } );
+            pairs.trades += 1;
+            pairs.set_invariant( 0, 0 );
+            trades.push_back( trade );
+
+            if ( protocol_fee.quantity.amount ) {
+                bool found = false;
+                for ( extended_asset& fee : fees ) {
+                    if ( fee.get_extended_symbol() != protocol_fee.get_extended_symbol() ) continue;
+                    fee += protocol_fee;
+                    found = true;
+                }
+                if ( !found ) fees.push_back( protocol_fee );
+            }
+            ext_in = { trade.quantity_out, reserve_out.contract };
+        }
+
+        // enforce minimum return (slippage protection)
+        check( ext_in.quantity.amount != 0 && ext_in.quantity.amount >= order.min_return, "curve.sx::batchswap: invalid minimum return");
+        balance_of( ext_in.get_extended_symbol() ) += ext_in;
+    }
+
+    // write each touched pair once
+    for ( const auto& item : loaded ) {
+        const pairs_row& pairs = item.second.first;
+        const uint64_t amplifier = item.second.second;
+        _pairs.modify( _pairs.get( pairs.id.raw() ), get_self(), [&]( auto & row ) {
+            upgrade_pair( row );
+            update_oracle( row, amplifier );
+            row.reserve0 = pairs.reserve0;
+            row.reserve1 = pairs.reserve1;
+            row.volume0 = pairs.volume0;
+            row.volume1 = pairs.volume1;
+            row.trades = pairs.trades;
+            update_amplifier( row, amplifier );
+            row.set_invariant( get_invariant( row, row.amplifier ), row.amplifier );
+            row.prices.emplace( price_params{ calculate_virtual_price( row ), pairs.prices.value().price0_last, pairs.prices.value().price1_last } );
+            row.last_updated = current_time_point();
+        });
+        update_observation( _pairs.get( pairs.id.raw() ), config.observation_interval.value_or( OBSERVATION_INTERVAL ) );
+    }
+
+    // accrue protocol fees once per token (see `claimfees`)
+    for ( const extended_asset& fee : fees ) accrue_fee( fee );
+
+    // trade log (single inline action for all orders)
+    if ( trades.size() ) {
+        curve::tradelog_action tradelog( get_self(), { get_self(), "active"_n });
+        tradelog.send( owner, "batchswap"_n, trades, config.stats_account.value_or() );
+    }
+
+    // settle net balances (one transfer per token) & clear deposited balances
+    for ( const extended_asset& balance : balances ) {
+        if ( balance.quantity.amount ) transfer( get_self(), owner, balance, "curve.sx: batch swap" );
+    }
+    for ( auto itr = _balances.begin(); itr != _balances.end(); ) {
+        itr = _balances.erase( itr );
+    }
+}
+
+// credit deposited balance for `batchswap` orders
+void curve::add_balance( const name owner, const extended_asset value )
+{
+    curve::balances_table _balances( get_self(), owner.value );
+    auto _balances_by_token = _balances.get_index<"bytoken"_n>();
+    auto itr = _balances_by_token.find( get_token_key( value.get_extended_symbol() ) );
+
+    if ( itr == _balances_by_token.end() ) {
+        _balances.emplace( get_self(), [&]( auto & row ) {
+            row.id = _balances.available_primary_key();
+            row.balance = value;
+        });
+    } else {
+        _balances_by_token.modify( itr, same_payer, [&]( auto & row ) {
+            row.balance += value;
+        });
+    }
+}
+
+} // namespace sx
@@ -0,0 +1,47 @@
+namespace sx {
+
+[[eosio::action]]
+void curve::setinterval( const uint32_t observation_interval )
+{
+    require_auth( get_self() );
+
+    check( observation_interval >= MIN_OBSERVATION_INTERVAL, "curve.sx::setinterval: `observation_interval` should be above " + to_string(MIN_OBSERVATION_INTERVAL) + " seconds");
+
+    curve::config_table _config( get_self(), get_self().value );
+    auto config = _config.get_or_default();
+    upgrade_config( config );
+    config.observation_interval.emplace( observation_interval );
+    _config.set( config, get_self() );
+}
+
+// record `pair` state in its ring buffer slot, at most once per `interval` (RAM is bounded by `OBSERVATION_SLOTS`)
+void curve::update_observation( const pairs_row& pair, const uint32_t interval )
+{
+    curve::observations_table _observations( get_self(), pair.id.raw() );
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const uint64_t slot = ( now / interval ) % OBSERVATION_SLOTS;
+
+    const auto insert = [&]( auto & row ) {
+        row.slot = slot;
+        row.timestamp = time_point_sec{ now };
+        row.virtual_price = pair.get_prices().virtual_price;
+        row.reserve0 = pair.reserve0.quantity;
+        row.reserve1 = pair.reserve1.quantity;
+        row.volume0 = pair.volume0;
+        row.volume1 = pair.volume1;
+    };
+
+    auto itr = _observations.find( slot );
+    if ( itr == _observations.end() ) _observations.emplace( get_self(), insert );
+    else if ( itr->timestamp.sec_since_epoch() / interval != now / interval ) _observations.modify( itr, same_payer, insert );
+}
+
+void curve::erase_observations( const symbol_code pair_id )
+{
+    curve::observations_table _observations( get_self(), pair_id.raw() );
+    for ( auto itr = _observations.begin(); itr != _observations.end(); ) {
+        itr = _observations.erase( itr );
+    }
+}
+
+} // namespace sx
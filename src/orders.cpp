@@ -0,0 +1,90 @@
+namespace sx {
+
+// returns all pending pair deposit orders of `owner` (see `orderindex`)
+[[eosio::action]]
+void curve::cancelall( const name owner )
+{
+    if ( !has_auth( get_self() )) require_auth( owner );
+
+    curve::orderindex_table _orderindex( get_self(), get_self().value );
+    auto _orderindex_by_owner = _orderindex.get_index<"byowner"_n>();
+    const uint128_t lower = static_cast<uint128_t>( owner.value ) << 64;
+
+    vector<symbol_code> pair_ids;
+    for ( auto itr = _orderindex_by_owner.lower_bound( lower ); itr != _orderindex_by_owner.end() && itr->owner == owner; ++itr ) {
+        pair_ids.push_back( itr->pair_id );
+    }
+    check( pair_ids.size(), "curve.sx::cancelall: no deposits for this user");
+    for ( const symbol_code pair_id : pair_ids ) refund_order( owner, pair_id, "curve.sx: cancel" );
+}
+
+// refunds & erases deposit orders older than `ORDER_EXPIRE_TIME`, oldest first (permissionless)
+// orders of `credit_owners` whose transfers can't be delivered are credited to their `balances` instead (admin only)
+[[eosio::action]]
+void curve::expireorders( const uint64_t max_rows, const vector<name> credit_owners )
+{
+    if ( credit_owners.size() ) require_auth( get_self() );
+
+    curve::orderindex_table _orderindex( get_self(), get_self().value );
+    auto _orderindex_by_created = _orderindex.get_index<"bycreated"_n>();
+    const uint32_t expired = current_time_point().sec_since_epoch() - ORDER_EXPIRE_TIME;
+
+    vector<pair<name, symbol_code>> orders;
+    for ( auto itr = _orderindex_by_created.begin(); itr != _orderindex_by_created.end() && orders.size() < max_rows; ++itr ) {
+        if ( itr->created_at.sec_since_epoch() > expired ) break;
+        orders.push_back( { itr->owner, itr->pair_id } );
+    }
+    check( orders.size(), "curve.sx::expireorders: no expired orders");
+    for ( const auto& [ owner, pair_id ] : orders ) {
+        if ( std::find( credit_owners.begin(), credit_owners.end(), owner ) != credit_owners.end() ) credit_order( owner, pair_id );
+        else refund_order( owner, pair_id, "curve.sx: expired" );
+    }
+}
+
+// transfer remaining deposits of pair order back to `owner` & erase order
+void curve::refund_order( const name owner, const symbol_code pair_id, const string memo )
+{
+    curve::orders_table _orders( get_self(), pair_id.raw() );
+    auto itr = _orders.find( owner.value );
+    if ( itr != _orders.end() ) {
+        if ( itr->quantity0.quantity.amount ) transfer( get_self(), owner, itr->quantity0, memo );
+        if ( itr->quantity1.quantity.amount ) transfer( get_self(), owner, itr->quantity1, memo );
+        _orders.erase( itr );
+    }
+    remove_order_index( owner, pair_id );
+}
+
+// credit remaining deposits of pair order to `owner` balances & erase order (withdrawn by `batchswap` without orders)
+void curve::credit_order( const name owner, const symbol_code pair_id )
+{
+    curve::orders_table _orders( get_self(), pair_id.raw() );
+    auto itr = _orders.find( owner.value );
+    if ( itr != _orders.end() ) {
+        if ( itr->quantity0.quantity.amount ) add_balance( owner, itr->quantity0 );
+        if ( itr->quantity1.quantity.amount ) add_balance( owner, itr->quantity1 );
+        _orders.erase( itr );
+    }
+    remove_order_index( owner, pair_id );
+}
+
+void curve::add_order_index( const name owner, const symbol_code pair_id )
+{
+    curve::orderindex_table _orderindex( get_self(), get_self().value );
+    _orderindex.emplace( get_self(), [&]( auto & row ) {
+        row.id = _orderindex.available_primary_key();
+        row.owner = owner;
+        row.pair_id = pair_id;
+        row.created_at = current_time_point();
+    });
+}
+
+// orders created before `orderindex` have no index row
+void curve::remove_order_index( const name owner, const symbol_code pair_id )
+{
+    curve::orderindex_table _orderindex( get_self(), get_self().value );
+    auto _orderindex_by_owner = _orderindex.get_index<"byowner"_n>();
+    auto itr = _orderindex_by_owner.find( static_cast<uint128_t>( owner.value ) << 64 | pair_id.raw() );
+    if ( itr != _orderindex_by_owner.end() ) _orderindex_by_owner.erase( itr );
+}
+
+} // namespace sx
@@ -0,0 +1,310 @@
+namespace sx {
+
+[[eosio::action]]
+void curve::createpool( const name creator, const symbol_code pool_id, const vector<extended_symbol> reserves, const uint64_t amplifier )
+{
+    // `creator` must be contract itself during beta period
+    if ( !has_auth( get_self() ) ) check( false, "curve.sx::createpool: `creator` is disabled from creating pool during beta period");
+    require_auth( creator );
+
+    // tables
+    curve::pools_table _pools( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+
+    // check reserves
+    check( reserves.size() >= MIN_POOL_COINS && reserves.size() <= MAX_POOL_COINS, "curve.sx::createpool: pool must have between " + to_string(MIN_POOL_COINS) + " and " + to_string(MAX_POOL_COINS) + " reserves" );
+    uint8_t precision = 0;
+    set<symbol_code> duplicates;
+    for ( const extended_symbol& reserve : reserves ) {
+        const symbol sym = reserve.get_symbol();
+        check( is_account( reserve.get_contract() ), "curve.sx::createpool: reserve contract does not exists");
+        check( token::get_supply( reserve.get_contract(), sym.code() ).symbol == sym, "curve.sx::createpool: reserve symbol mismatch" );
+        check( sym.precision() <= MAX_PRECISION, "curve.sx::createpool: only tokens with precision <= `MAX_PRECISION` allowed" );
+        check( !duplicates.count( sym.code() ), "curve.sx::createpool: duplicate reserve symbol codes");
+        duplicates.insert( sym.code() );
+        precision = max( precision, sym.precision() );
+    }
+    check( _pools.find( pool_id.raw() ) == _pools.end(), "curve.sx::createpool: `pool_id` already exists" );
+    check( _pairs.find( pool_id.raw() ) == _pairs.end(), "curve.sx::createpool: `pool_id` already exists in `pairs`" );
+    check( amplifier > 0 && amplifier <= MAX_AMPLIFIER, "curve.sx::createpool: invalid amplifier" );
+
+    // create liquidity token
+    const extended_symbol liquidity = {{ pool_id, precision }, TOKEN_CONTRACT };
+
+    // in case supply already exists
+    token::stats _stats( TOKEN_CONTRACT, pool_id.raw() );
+    auto stats_itr = _stats.find( pool_id.raw() );
+
+    // create token if supply does not exist
+    if ( stats_itr == _stats.end() ) create( liquidity );
+    // supply must be empty
+    else check( !stats_itr->supply.amount, "curve.sx::createpool: creating new pool requires existing supply to be zero" );
+
+    // create pool
+    _pools.emplace( creator, [&]( auto & row ) {
+        row.id = pool_id;
+        for ( const extended_symbol& reserve : reserves ) {
+            row.reserves.push_back( { 0, reserve } );
+            row.volumes.push_back( { 0, reserve.get_symbol() } );
+        }
+        row.liquidity = { 0, liquidity };
+        row.amplifier = amplifier;
+        row.last_updated = current_time_point();
+        row.invariant = 0;
+        row.invariant_amplifier = amplifier;
+    });
+}
+
+[[eosio::action]]
+void curve::removepool( const symbol_code pool_id )
+{
+    require_auth( get_self() );
+
+    curve::pools_table _pools( get_self(), get_self().value );
+    auto & pool = _pools.get( pool_id.raw(), "curve.sx::removepool: `pool_id` does not exist");
+    check( !pool.liquidity.quantity.amount, "curve.sx::removepool: liquidity must be empty before removing");
+    _pools.erase( pool );
+}
+
+void curve::convert_pool( const name owner, const extended_asset ext_in, const symbol_code pool_id, const symbol_code symcode_out, const int64_t min_return )
+{
+    curve::pools_table _pools( get_self(), get_self().value );
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
+
+    const auto& pool = _pools.get( pool_id.raw(), "curve.sx::convert_pool: `pool_id` does not exist");
+    const size_t i = get_pool_index( pool, ext_in.quantity.symbol.code() );
+    const size_t j = get_pool_index( pool, symcode_out );
+    const extended_asset reserve_out = pool.reserves[j];
+
+    // validate input quantity & reserves
+    check(pool.reserves[i].get_extended_symbol() == ext_in.get_extended_symbol(), "curve.sx::convert_pool: incoming currency/reserves contract mismatch");
+    check(pool.invariant != 0, "curve.sx::convert_pool: empty pool reserves");
+
+    // calculate out (same calculation as `get_pool_amount_out`, with loaded rows)
+    const extended_asset ext_out = { get_pool_amount_out( ext_in.quantity, pool, config, symcode_out ), reserve_out.contract };
+
+    // enforce minimum return (slippage protection)
+    check(ext_out.quantity.amount != 0 && ext_out.quantity.amount >= min_return, "curve.sx::convert_pool: invalid minimum return");
+
+    // protocol & trade fees
+    const extended_asset protocol_fee = { ext_in.quantity.amount * config.protocol_fee / 10000, ext_in.get_extended_symbol() };
+    const extended_asset trade_fee = { ext_in.quantity.amount * config.trade_fee / 10000, ext_in.get_extended_symbol() };
+    const extended_asset fee = protocol_fee + trade_fee;
+
+    // modify reserves
+    _pools.modify( pool, get_self(), [&]( auto & row ) {
+        row.reserves[i].quantity += ext_in.quantity - protocol_fee.quantity;
+        row.reserves[j].quantity -= ext_out.quantity;
+        row.volumes[i] += ext_in.quantity;
+
+        const uint64_t price = calculate_price( ext_in.quantity, ext_out.quantity );
+        row.invariant = get_pool_invariant( row, row.amplifier );
+        row.invariant_amplifier = row.amplifier;
+        row.virtual_price = calculate_pool_virtual_price( row.reserves, row.liquidity.quantity );
+        row.trades += 1;
+        row.last_updated = current_time_point();
+
+        // trade log (input & output reserves)
+        curve::tradelog_action tradelog( get_self(), { get_self(), "active"_n });
+        tradelog.send( owner, "swap"_n, vector<trade_record>{{ pool_id, ext_in.quantity, ext_out.quantity, fee.quantity, price, row.reserves[i].quantity, row.reserves[j].quantity }}, config.stats_account.value_or() );
+    });
+    // accrue protocol fees (see `claimfees`)
+    if ( protocol_fee.quantity.amount ) accrue_fee( protocol_fee );
+
+    // transfer amount to owner
+    transfer( get_self(), owner, ext_out, "curve.sx: swap token" );
+}
+
+void curve::add_pool_liquidity( const name owner, const symbol_code pool_id, const extended_asset value )
+{
+    curve::pools_table _pools( get_self(), get_self().value );
+    curve::poolorders_table _orders( get_self(), pool_id.raw() );
+
+    // get current order & pool
+    auto pool = _pools.get( pool_id.raw(), "curve.sx::add_pool_liquidity: `pool_id` does not exist");
+    auto itr = _orders.find( owner.value );
+
+    // initialize quantities
+    auto insert = [&]( auto & row ) {
+        row.owner = owner;
+        if ( itr == _orders.end() ) {
+            for ( const extended_asset& reserve : pool.reserves ) row.quantities.push_back( { 0, reserve.get_extended_symbol() } );
+        }
+
+        // add & validate deposit
+        const size_t i = get_pool_index( pool, value.quantity.symbol.code() );
+        check( row.quantities[i].get_extended_symbol() == value.get_extended_symbol(), "curve.sx::add_pool_liquidity: invalid extended symbol when adding liquidity");
+        row.quantities[i] += value;
+    };
+
+    // create/modify order
+    if ( itr == _orders.end() ) _orders.emplace( get_self(), insert );
+    else _orders.modify( itr, get_self(), insert );
+}
+
+void curve::deposit_pool( const name owner, const symbol_code pool_id )
+{
+    curve::pools_table _pools( get_self(), get_self().value );
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
+    curve::poolorders_table _orders( get_self(), pool_id.raw() );
+
+    // get current order & pool
+    auto & pool = _pools.get( pool_id.raw(), "curve.sx::deposit: `pool_id` does not exist");
+    auto & orders = _orders.get( owner.value, "curve.sx::deposit: no deposits available for this user");
+    const size_t n = pool.reserves.size();
+
+    // calculate total deposits based on reserves: reserves ratio should remain the same
+    // if reserves empty, fallback to 1
+    vector<int128_t> reserves( n ), amounts( n ), deposits( n );
+    int128_t reserves_sum = 0, deposits_sum = 0;
+    size_t min_k = 0;
+    for ( size_t k = 0; k < n; ++k ) {
+        const symbol sym = pool.reserves[k].quantity.symbol;
+        check( orders.quantities[k].quantity.amount, "curve.sx::deposit: one of the deposit is empty");
+        reserves[k] = pool.reserves[k].quantity.amount ? mul_amount(pool.reserves[k].quantity.amount, MAX_PRECISION, sym.precision()) : 1;
+        amounts[k] = mul_amount(orders.quantities[k].quantity.amount, MAX_PRECISION, sym.precision());
+        reserves_sum += reserves[k];
+
+        // smallest deposit relative to its reserve limits all other deposits
+        if ( amounts[k] * reserves[min_k] < amounts[min_k] * reserves[k] ) min_k = k;
+    }
+
+    // calculate actual amounts to deposit & send back excess deposit to owner
+    vector<extended_asset> ext_deposits;
+    vector<asset> quantities;
+    for ( size_t k = 0; k < n; ++k ) {
+        const symbol sym = pool.reserves[k].quantity.symbol;
+        deposits[k] = k == min_k ? amounts[k] : amounts[min_k] * reserves[k] / reserves[min_k];
+        deposits_sum += deposits[k];
+
+        if ( deposits[k] < amounts[k] ) {
+            const int64_t excess_amount = div_amount(static_cast<int64_t>(amounts[k] - deposits[k]), MAX_PRECISION, sym.precision());
+            const extended_asset excess = { excess_amount, pool.reserves[k].get_extended_symbol() };
+            if ( excess.quantity.amount ) transfer( get_self(), owner, excess, "curve.sx: excess");
+        }
+        // normalize final deposits
+        ext_deposits.push_back( { div_amount(static_cast<int64_t>(deposits[k]), MAX_PRECISION, sym.precision()), pool.reserves[k].get_extended_symbol() } );
+        quantities.push_back( ext_deposits[k].quantity );
+    }
+
+    // issue liquidity
+    const int64_t supply = mul_amount(pool.liquidity.quantity.amount, MAX_PRECISION, pool.liquidity.quantity.symbol.precision());
+    const int64_t issued_amount = rex::issue(deposits_sum, reserves_sum, supply, 1);
+    const extended_asset issued = { div_amount(issued_amount, MAX_PRECISION, pool.liquidity.quantity.symbol.precision()), pool.liquidity.get_extended_symbol()};
+
+    // add liquidity deposits & newly issued liquidity
+    _pools.modify(pool, get_self(), [&]( auto & row ) {
+        vector<asset> reserves;
+        for ( size_t k = 0; k < n; ++k ) {
+            row.reserves[k] += ext_deposits[k];
+            reserves.push_back( row.reserves[k].quantity );
+        }
+        row.liquidity += issued;
+        row.invariant = get_pool_invariant( row, row.amplifier );
+        row.invariant_amplifier = row.amplifier;
+        row.virtual_price = calculate_pool_virtual_price( row.reserves, row.liquidity.quantity );
+
+        // log liquidity change
+        curve::poollog_action poollog( get_self(), { get_self(), "active"_n });
+        poollog.send( pool_id, owner, "deposit"_n, issued.quantity, quantities, row.liquidity.quantity, reserves, config.stats_account.value_or() );
+    });
+
+    // issue & transfer to owner
+    issue( issued, "curve.sx: deposit" );
+    transfer( get_self(), owner, issued, "curve.sx: deposit");
+
+    // delete any remaining liquidity deposit order
+    _orders.erase( orders );
+}
+
+void curve::cancel_pool( const name owner, const symbol_code pool_id )
+{
+    curve::poolorders_table _orders( get_self(), pool_id.raw() );
+    auto & orders = _orders.get( owner.value, "curve.sx::cancel: no deposits for this user in this pool");
+    for ( const extended_asset& quantity : orders.quantities ) {
+        if ( quantity.quantity.amount ) transfer( get_self(), owner, quantity, "curve.sx: cancel");
+    }
+    _orders.erase( orders );
+}
+
+void curve::withdraw_pool_liquidity( const name owner, const extended_asset value )
+{
+    curve::pools_table _pools( get_self(), get_self().value );
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
+
+    // get current pool
+    const symbol_code pool_id = value.quantity.symbol.code();
+    auto & pool = _pools.get( pool_id.raw(), "curve.sx::withdraw_liquidity: `pool_id` does not exist");
+    const size_t n = pool.reserves.size();
+
+    // prevent invalid liquidity token contracts
+    check(pool.liquidity.get_extended_symbol() == value.get_extended_symbol(), "curve.sx::withdraw_liquidity: invalid liquidity contract");
+
+    // calculate total deposits based on reserves
+    const int64_t supply = mul_amount(pool.liquidity.quantity.amount, MAX_PRECISION, pool.liquidity.quantity.symbol.precision());
+    vector<int128_t> reserves( n );
+    int128_t reserves_sum = 0;
+    for ( size_t k = 0; k < n; ++k ) {
+        const symbol sym = pool.reserves[k].quantity.symbol;
+        reserves[k] = pool.reserves[k].quantity.amount ? mul_amount(pool.reserves[k].quantity.amount, MAX_PRECISION, sym.precision()) : 1;
+        reserves_sum += reserves[k];
+    }
+
+    // calculate withdraw amounts (pro-rata of each reserve)
+    const int64_t payment = mul_amount(value.quantity.amount, MAX_PRECISION, value.quantity.symbol.precision());
+    const int64_t retire_amount = rex::retire( payment, reserves_sum, supply );
+    const bool is_final = value.quantity.amount == pool.liquidity.quantity.amount;    // deal with rounding error on final withdrawal
+
+    vector<extended_asset> outs;
+    vector<asset> quantities;
+    bool is_empty = true;
+    for ( size_t k = 0; k < n; ++k ) {
+        const symbol sym = pool.reserves[k].quantity.symbol;
+        const extended_asset out = is_final ? pool.reserves[k] : extended_asset{ div_amount(static_cast<int64_t>( retire_amount * reserves[k] / reserves_sum ), MAX_PRECISION, sym.precision()), pool.reserves[k].get_extended_symbol() };
+        if ( out.quantity.amount ) is_empty = false;
+        outs.push_back( out );
+        quantities.push_back( -out.quantity );
+    }
+    check( !is_empty, "curve.sx::withdraw_liquidity: withdraw amount too small");
+
+    // remove liquidity withdrawals & retired liquidity
+    _pools.modify(pool, get_self(), [&]( auto & row ) {
+        vector<asset> reserves;
+        for ( size_t k = 0; k < n; ++k ) {
+            row.reserves[k] -= outs[k];
+            reserves.push_back( row.reserves[k].quantity );
+        }
+        row.liquidity -= value;
+        row.invariant = get_pool_invariant( row, row.amplifier );
+        row.invariant_amplifier = row.amplifier;
+        if ( row.liquidity.quantity.amount ) row.virtual_price = calculate_pool_virtual_price( row.reserves, row.liquidity.quantity );
+
+        // log liquidity change
+        curve::poollog_action poollog( get_self(), { get_self(), "active"_n });
+        poollog.send( pool_id, owner, "withdraw"_n, value.quantity, quantities, row.liquidity.quantity, reserves, config.stats_account.value_or() );
+    });
+
+    // retire & transfer to owner
+    retire( value, "curve.sx: withdraw" );
+    for ( const extended_asset& out : outs ) {
+        if ( out.quantity.amount ) transfer( get_self(), owner, out, "curve.sx: withdraw");
+    }
+}
+
+// calculate pool reserve amounts relative to supply (scaled by `Curve::PRICE_SCALE`, saturated)
+uint64_t curve::calculate_pool_virtual_price( const vector<extended_asset>& reserves, const asset supply )
+{
+    const int64_t supply_amount = mul_amount( supply.amount, MAX_PRECISION, supply.symbol.precision() );
+    if ( !supply_amount ) return 0;
+    int64_t amount = 0;
+    for ( const extended_asset& reserve : reserves ) {
+        amount = safemath::add( amount, mul_amount( reserve.quantity.amount, MAX_PRECISION, reserve.quantity.symbol.precision() ) );
+    }
+    const uint128_t price = static_cast<uint128_t>( amount ) * Curve::PRICE_SCALE / supply_amount;
+    return price > UINT64_MAX ? UINT64_MAX : static_cast<uint64_t>( price );
+}
+
+} // namespace sx
@@ -0,0 +1,64 @@
+namespace sx {
+
+// batch quote of swap paths, returned as action return value (no table modifications)
+// each request is quoted against current reserves, pair rows & amplifiers are loaded once per batch
+[[eosio::action, eosio::read_only]]
+vector<curve::quote_result> curve::quote( const vector<quote_request> requests )
+{
+    curve::config_table _config( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    check( _config.exists(), ERROR_CONFIG_NOT_EXISTS );
+    const auto config = _config.get();
+
+    // already loaded pair rows & current amplifiers
+    map<symbol_code, pair<const pairs_row*, uint64_t>> loaded;
+
+    vector<quote_result> results;
+    results.reserve( requests.size() );
+    for ( const quote_request& request : requests ) {
+        check( request.pair_ids.size() >= 1, "curve.sx::quote: `pair_ids` cannot be empty");
+        quote_result result = { request.in, {} };
+        for ( const symbol_code pair_id : request.pair_ids ) {
+            auto itr = loaded.find( pair_id );
+            if ( itr == loaded.end() ) {
+                const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::quote: `pair_id` does not exist");
+                itr = loaded.emplace( pair_id, make_pair( &pairs, get_amplifier( pairs ) ) ).first;
+            }
+            const trade_record trade = get_trade( result.out, *itr->second.first, config, itr->second.second );
+            result.trades.push_back( trade );
+            result.out = trade.quantity_out;
+        }
+        results.push_back( result );
+    }
+    return results;
+}
+
+// output-vs-input curve of a pair, returned as action return value (no table modifications)
+[[eosio::action, eosio::read_only]]
+vector<asset> curve::depth( const symbol_code pair_id, const vector<asset> amounts_in )
+{
+    return get_depth_ladder( amounts_in, pair_id );
+}
+
+// marginal rate of `symcode_in` reserve scaled by `Curve::PRICE_SCALE`, returned as action return value
+[[eosio::action, eosio::read_only]]
+uint64_t curve::spotprice( const symbol_code pair_id, const symbol_code symcode_in )
+{
+    return get_spot_price( pair_id, symcode_in );
+}
+
+// liquidity issued by `deposit` for balanced deposit quantities, returned as action return value
+[[eosio::action, eosio::read_only]]
+curve::deposit_result curve::depositout( const symbol_code pair_id, const asset quantity0, const asset quantity1 )
+{
+    return get_deposit_out( pair_id, quantity0, quantity1 );
+}
+
+// reserves paid out for withdrawing `liquidity`, returned as action return value
+[[eosio::action, eosio::read_only]]
+curve::withdraw_result curve::withdrawout( const asset liquidity )
+{
+    return get_withdraw_out( liquidity );
+}
+
+} // namespace sx
@@ -0,0 +1,187 @@
+namespace sx {
+
+// best route (highest output) from `ext_in` to any `symcode_out` reserve, up to `MAX_ROUTE_HOPS` pairs & `MAX_ROUTE_QUOTES` quoted hops
+vector<symbol_code> curve::find_route( const extended_asset ext_in, const symbol_code symcode_out )
+{
+    curve::config_table _config( get_self(), get_self().value );
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    const auto config = _config.get();
+
+    vector<symbol_code> path;
+    vector<symbol_code> best_path;
+    int64_t best_out = 0;
+    uint8_t quotes = MAX_ROUTE_QUOTES;
+    search_routes( ext_in, symcode_out, config, _pairs, path, best_path, best_out, quotes );
+    check( best_path.size(), "curve.sx::find_route: no route found");
+
+    return best_path;
+}
+
+// depth-first search over pairs holding incoming token (`byreserve0` & `byreserve1` indices), each route prefix is quoted once
+// search stops once `quotes` budget is spent, rows are cached by the `_pairs` instance across hops
+void curve::search_routes( const extended_asset ext_in, const symbol_code symcode_out, const config_row& config, pairs_table& _pairs, vector<symbol_code>& path, vector<symbol_code>& best_path, int64_t& best_out, uint8_t& quotes )
+{
+    // pairs holding incoming token
+    const uint128_t key = get_token_key( ext_in.get_extended_symbol() );
+    vector<const pairs_row*> rows;
+    auto _pairs_by_reserve0 = _pairs.get_index<"byreserve0"_n>();
+    for ( auto itr = _pairs_by_reserve0.lower_bound( key ); itr != _pairs_by_reserve0.end() && itr->by_reserve0() == key; ++itr ) {
+        rows.push_back( &*itr );
+    }
+    auto _pairs_by_reserve1 = _pairs.get_index<"byreserve1"_n>();
+    for ( auto itr = _pairs_by_reserve1.lower_bound( key ); itr != _pairs_by_reserve1.end() && itr->by_reserve1() == key; ++itr ) {
+        rows.push_back( &*itr );
+    }
+
+    for ( const pairs_row* row : rows ) {
+        const auto& pairs = *row;
+        const symbol_code pair_id = pairs.id;
+        if ( std::find( path.begin(), path.end(), pair_id ) != path.end() ) continue;
+
+        // skip empty pairs & quantities below minimum fee (would fail `get_amount_out`)
+        if ( !pairs.reserve0.quantity.amount || !pairs.reserve1.quantity.amount ) continue;
+        if ( config.trade_fee && !(ext_in.quantity.amount * config.trade_fee / 10000) ) continue;
+
+        // quote hop
+        if ( !quotes ) return;
+        --quotes;
+        const bool is_in = pairs.reserve0.get_extended_symbol() == ext_in.get_extended_symbol();
+        const extended_asset ext_out = { get_amount_out( ext_in.quantity, pairs, config, get_amplifier( pairs ) ), is_in ? pairs.reserve1.contract : pairs.reserve0.contract };
+        if ( !ext_out.quantity.amount ) continue;
+
+        // route reaches output token, otherwise continue search from output token
+        path.push_back( pair_id );
+        if ( ext_out.quantity.symbol.code() == symcode_out ) {
+            if ( ext_out.quantity.amount > best_out ) {
+                best_out = ext_out.quantity.amount;
+                best_path = path;
+            }
+        } else if ( path.size() < MAX_ROUTE_HOPS ) {
+            search_routes( ext_out, symcode_out, config, _pairs, path, best_path, best_out, quotes );
+        }
+        path.pop_back();
+    }
+}
+
+// split `ext_in` across parallel routes `legs` (fixed `weights` in percent or optimized allocation), outputs are summed into a single transfer
+void curve::convert_split( const name owner, const extended_asset ext_in, const vector<vector<symbol_code>> legs, const vector<uint64_t> weights, const int64_t min_return )
+{
+    curve::pairs_table _pairs( get_self(), get_self().value );
+    curve::config_table _config( get_self(), get_self().value );
+    const auto config = _config.get();
+
+    // legs must not share pairs & must end in the same output token
+    vector<symbol_code> seen;
+    extended_symbol ext_sym_out;
+    for ( const vector<symbol_code>& leg : legs ) {
+        extended_symbol ext_sym = ext_in.get_extended_symbol();
+        for ( const symbol_code pair_id : leg ) {
+            check( std::find( seen.begin(), seen.end(), pair_id ) == seen.end(), "curve.sx::convert_split: legs must not share pairs");
+            seen.push_back( pair_id );
+
+            const auto& pairs = _pairs.get( pair_id.raw(), "curve.sx::convert_split: `pair_id` does not exist");
+            check( pairs.reserve0.get_extended_symbol() == ext_sym || pairs.reserve1.get_extended_symbol() == ext_sym, "curve.sx::convert_split: incoming currency/reserves contract mismatch");
+            ext_sym = pairs.reserve0.get_extended_symbol() == ext_sym ? pairs.reserve1.get_extended_symbol() : pairs.reserve0.get_extended_symbol();
+        }
+        if ( &leg == &legs[0] ) ext_sym_out = ext_sym;
+        check( ext_sym == ext_sym_out, "curve.sx::convert_split: legs output mismatch");
+    }
+
+    // allocate input amount to each leg
+    vector<int64_t> amounts( legs.size() );
+    if ( weights.size() ) {
+        uint64_t total = 0;
+        for ( const uint64_t weight : weights ) {
+            check( weight <= 100, "curve.sx::convert_split: weights must sum to 100");
+            total += weight;
+        }
+        check( total == 100, "curve.sx::convert_split: weights must sum to 100");
+
+        int64_t allocated = 0;
+        for ( size_t i = 0; i < legs.size(); ++i ) {
+            amounts[i] = static_cast<int64_t>( static_cast<uint128_t>( ext_in.quantity.amount ) * weights[i] / 100 );
+            allocated += amounts[i];
+        }
+        // rounding remainder to largest weight
+        amounts[ std::max_element( weights.begin(), weights.end() ) - weights.begin() ] += ext_in.quantity.amount - allocated;
+    } else {
+        amounts = get_split_amounts( ext_in, legs, config, _pairs );
+    }
+
+    // execute each leg (empty allocations are skipped)
+    vector<trade_record> trades;
+    extended_asset out = { 0, ext_sym_out };
+    for ( size_t i = 0; i < legs.size(); ++i ) {
+        if ( !amounts[i] ) continue;
+        out += apply_trade( { amounts[i], ext_in.get_extended_symbol() }, legs[i], config, trades );
+    }
+
+    // enforce minimum return (slippage protection)
+    check(out.quantity.amount != 0 && out.quantity.amount >= min_return, "curve.sx::convert_split: invalid minimum return");
+
+    // trade log (single inline action for all legs)
+    curve::tradelog_action tradelog( get_self(), { get_self(), "active"_n });
+    tradelog.send( owner, "swap"_n, trades, config.stats_account.value_or() );
+
+    // transfer amount to owner
+    transfer( get_self(), owner, out, "curve.sx: swap token" );
+}
+
+// water-filling allocation: each of `SPLIT_STEPS` chunks goes to the leg with the highest marginal rate (after fees), simulated on copies of the rows
+vector<int64_t> curve::get_split_amounts( const extended_asset ext_in, const vector<vector<symbol_code>> legs, const config_row& config, pairs_table& _pairs )
+{
+    // copies of rows & current amplifiers per leg (read once)
+    vector<vector<pair<pairs_row, uint64_t>>> rows;
+    for ( const vector<symbol_code>& leg : legs ) {
+        rows.emplace_back();
+        for ( const symbol_code pair_id : leg ) {
+            const auto& row = _pairs.get( pair_id.raw(), "curve.sx::get_split_amounts: `pair_id` does not exist");
+            rows.back().push_back( std::make_pair( row, get_amplifier( row ) ) );
+        }
+    }
+
+    // single step if chunks would be below minimum fee
+    const int64_t amount = ext_in.quantity.amount;
+    int64_t steps = SPLIT_STEPS;
+    if ( amount / steps == 0 || ( config.trade_fee && !( amount / steps * config.trade_fee / 10000 ) ) ) steps = 1;
+    const int64_t chunk = amount / steps;
+
+    vector<int64_t> amounts( legs.size() );
+    for ( int64_t step = 0; step < steps; ++step ) {
+        // marginal rate of each leg (product of spot prices scaled by `PRICE_SCALE`, net of fees per hop)
+        size_t best = legs.size();
+        uint128_t best_rate = 0;
+        for ( size_t i = 0; i < legs.size(); ++i ) {
+            uint128_t rate = Curve::PRICE_SCALE;
+            symbol_code symcode = ext_in.quantity.symbol.code();
+            for ( const auto& [ pairs, amplifier ] : rows[i] ) {
+                if ( !pairs.reserve0.quantity.amount || !pairs.reserve1.quantity.amount ) { rate = 0; break; }
+                rate = rate * get_spot_price( pairs, symcode, amplifier ) / Curve::PRICE_SCALE;
+                rate = rate * ( 10000 - config.trade_fee - config.protocol_fee ) / 10000;
+                symcode = pairs.reserve0.quantity.symbol.code() == symcode ? pairs.reserve1.quantity.symbol.code() : pairs.reserve0.quantity.symbol.code();
+            }
+            if ( rate > best_rate ) {
+                best_rate = rate;
+                best = i;
+            }
+        }
+        check( best < legs.size(), "curve.sx::get_split_amounts: no liquidity in split routes");
+
+        // simulate chunk on best leg
+        asset in = { chunk, ext_in.quantity.symbol };
+        for ( auto& [ pairs, amplifier ] : rows[best] ) {
+            const trade_record trade = get_trade( in, pairs, config, amplifier );
+            pairs.reserve0.quantity = trade.reserve0;
+            pairs.reserve1.quantity = trade.reserve1;
+            pairs.set_invariant( 0, 0 ); // cached invariant no longer matches reserves
+            in = trade.quantity_out;
+        }
+        amounts[best] += chunk;
+    }
+    // rounding remainder to largest allocation
+    amounts[ std::max_element( amounts.begin(), amounts.end() ) - amounts.begin() ] += amount - chunk * steps;
+
+    return amounts;
+}
+
+} // namespace sx
@@ -2,6 +2,7 @@
 
 cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
 
+bats ./__tests__/kernel.bats
 bats ./__tests__/system.bats
 bats ./__tests__/config.bats
 bats ./__tests__/formula.bats
@@ -9,4 +10,8 @@ bats ./__tests__/create_pairs.bats
 bats ./__tests__/liquidity.bats
 bats ./__tests__/swaps.bats
 bats ./__tests__/ramp.bats
+bats ./__tests__/pools.bats
+bats ./__tests__/deposit.bats
+bats ./__tests__/quotes.bats
+bats ./__tests__/batch.bats
 bats ./__tests__/withdraw.bats
\ No newline at end of file